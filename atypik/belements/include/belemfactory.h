@@ -26,6 +26,7 @@
 #define BELEMFACTORY_H
 
 #include "any.h"
+#include "arena.h"
 #include "assert.h"
 #include "assignments.h"
 #include "bdefaulttypes.h"
@@ -58,9 +59,24 @@
 
 namespace belem
 {
+/*!
+ * \brief The Factory class creates the B elements in the arena of a session
+ */
 class Factory
 {
 public:
+    /*!
+     * \brief Instanciate a factory allocating in the arena of the session bound
+     * to the current thread. The arena is resolved once, and the elements
+     * keep it alive.
+     */
+    Factory();
+    /*!
+     * \brief An accessor on the allocator of the elements, which keeps the
+     * arena of the session alive
+     * \return the allocator
+     */
+    const tools::ArenaAllocator<std::byte> &getAllocator() const;
     // Expressions
     /*!
      * \brief Create a B binary expression
@@ -74,10 +90,10 @@ public:
      * The position of the binary expression
      * \return a pointer on the binary expression
      */
-    static BinaryExp::shared_ptr makeBinaryExp(Expression::shared_ptr left,
-                                               std::string op,
-                                               Expression::shared_ptr right,
-                                               bxml::Position::shared_ptr position);
+    BinaryExp::shared_ptr makeBinaryExp(Expression::shared_ptr left,
+                                        std::string op,
+                                        Expression::shared_ptr right,
+                                        bxml::Position::shared_ptr position);
     /*!
      * \brief Create a B boolean
      * \param value
@@ -86,8 +102,8 @@ public:
      * The position of the boolean
      * \return a pointer on the boolean
      */
-    static BBool::shared_ptr makeBool(std::string value,
-                                      bxml::Position::shared_ptr position);
+    BBool::shared_ptr makeBool(std::string value,
+                               bxml::Position::shared_ptr position);
     /*!
      * \brief Create a B boolean expression
      * \param predicate
@@ -96,8 +112,8 @@ public:
      * The position of the boolean expression
      * \return a pointer on the boolean expression
      */
-    static BooleanExpression::shared_ptr makeBooleanExp(Predicate::shared_ptr predicate,
-                                                        bxml::Position::shared_ptr position);
+    BooleanExpression::shared_ptr makeBooleanExp(Predicate::shared_ptr predicate,
+                                                 bxml::Position::shared_ptr position);
     /*!
      * \brief Create a B integer
      * \param value
@@ -106,8 +122,8 @@ public:
      * The position of the integer
      * \return a pointer on the integer
      */
-    static BInteger::shared_ptr makeInt(std::string value,
-                                        bxml::Position::shared_ptr position);
+    BInteger::shared_ptr makeInt(std::string value,
+                                 bxml::Position::shared_ptr position);
     /*!
      * \brief Create a B real
      * \param value
@@ -116,8 +132,8 @@ public:
      * The position of the real
      * \return a pointer on the real
      */
-    static BReal::shared_ptr makeReal(std::string value,
-                                      bxml::Position::shared_ptr position);
+    BReal::shared_ptr makeReal(std::string value,
+                               bxml::Position::shared_ptr position);
     /*!
      * \brief Create a B string
      * \param value
@@ -126,8 +142,8 @@ public:
      * The position of the string
      * \return a pointer on the string
      */
-    static BString::shared_ptr makeString(std::string value,
-                                          bxml::Position::shared_ptr position);
+    BString::shared_ptr makeString(std::string value,
+                                   bxml::Position::shared_ptr position);
     /*!
      * \brief Create an B identifier
      * \param value
@@ -136,8 +152,8 @@ public:
      * The position of the identifier
      * \return a pointer on an Ident
      */
-    static Ident::shared_ptr makeIdent(std::string value,
-                                       bxml::Position::shared_ptr position);
+    Ident::shared_ptr makeIdent(std::string value,
+                                bxml::Position::shared_ptr position);
     /*!
      * \brief Create a B set
      * \param id
@@ -148,9 +164,9 @@ public:
      * The position of the identifier
      * \return a pointer on a Set
      */
-    static Set::shared_ptr makeSet(Ident::shared_ptr id,
-                                   std::vector<Expression::shared_ptr> content,
-                                   bxml::Position::shared_ptr position);
+    Set::shared_ptr makeSet(Ident::shared_ptr id,
+                            std::vector<Expression::shared_ptr> content,
+                            bxml::Position::shared_ptr position);
     /*!
      * \brief Create a B unary expression
      * \param op
@@ -161,9 +177,9 @@ public:
      * The position of the identifier
      * \return a pointer on an UnaryExp
      */
-    static UnaryExp::shared_ptr makeUnaryExp(std::string op,
-                                             Expression::shared_ptr expression,
-                                             bxml::Position::shared_ptr position);
+    UnaryExp::shared_ptr makeUnaryExp(std::string op,
+                                      Expression::shared_ptr expression,
+                                      bxml::Position::shared_ptr position);
     /*!
      * \brief Create a B n-arity expression
      * \param operands
@@ -174,9 +190,9 @@ public:
      * The position of the n-arity expression
      * \return a pointer on a NaryExp
      */
-    static NaryExp::shared_ptr makeNaryExp(std::vector<Expression::shared_ptr> operands,
-                                           std::string op,
-                                           bxml::Position::shared_ptr position);
+    NaryExp::shared_ptr makeNaryExp(std::vector<Expression::shared_ptr> operands,
+                                    std::string op,
+                                    bxml::Position::shared_ptr position);
     /*!
      * \brief Create a B quantified expression
      * \param type
@@ -191,11 +207,11 @@ public:
      * The position of the expression
      * \return a pointer on a QuantifiedExp
      */
-    static QuantifiedExp::shared_ptr makeQuantifiedExp(std::string type,
-                                                       std::vector<Expression::shared_ptr> identifiers,
-                                                       Predicate::shared_ptr predicate,
-                                                       Expression::shared_ptr expression,
-                                                       bxml::Position::shared_ptr position);
+    QuantifiedExp::shared_ptr makeQuantifiedExp(std::string type,
+                                                std::vector<Expression::shared_ptr> identifiers,
+                                                Predicate::shared_ptr predicate,
+                                                Expression::shared_ptr expression,
+                                                bxml::Position::shared_ptr position);
     /*!
      * \brief Create a B quantified set
      * \param expressions
@@ -206,9 +222,9 @@ public:
      * The position of the set
      * \return a pointer on a QuantifiedSet
      */
-    static QuantifiedSet::shared_ptr makeQuantifiedSet(std::vector<Expression::shared_ptr> expression,
-                                                       Predicate::shared_ptr predicate,
-                                                       bxml::Position::shared_ptr position);
+    QuantifiedSet::shared_ptr makeQuantifiedSet(std::vector<Expression::shared_ptr> expression,
+                                                Predicate::shared_ptr predicate,
+                                                bxml::Position::shared_ptr position);
     /*!
      * \brief Create a B valuation
      * \param variable
@@ -219,9 +235,9 @@ public:
      * The position of the valuation
      * \return a pointer on a Valuation
      */
-    static Valuation::shared_ptr makeValuation(Expression::shared_ptr variable,
-                                               Expression::shared_ptr value,
-                                               bxml::Position::shared_ptr position);
+    Valuation::shared_ptr makeValuation(Expression::shared_ptr variable,
+                                        Expression::shared_ptr value,
+                                        bxml::Position::shared_ptr position);
 
     // Predicates
     /*!
@@ -234,9 +250,9 @@ public:
      * The right operand
      * \return a pointer on a Comparison
      */
-    static Comparison::shared_ptr makeComparison(Expression::shared_ptr left,
-                                                 std::string op,
-                                                 Expression::shared_ptr right);
+    Comparison::shared_ptr makeComparison(Expression::shared_ptr left,
+                                          std::string op,
+                                          Expression::shared_ptr right);
     /*!
      * \brief Create a n-arity predicate
      * \param clauses
@@ -245,8 +261,8 @@ public:
      * The operator
      * \return a pointer on a NaryPred
      */
-    static NaryPred::shared_ptr makeNaryPred(std::vector<Predicate::shared_ptr> clauses,
-                                             std::string op);
+    NaryPred::shared_ptr makeNaryPred(std::vector<Predicate::shared_ptr> clauses,
+                                      std::string op);
     /*!
      * \brief Create a unary predicate
      * \param op
@@ -255,7 +271,7 @@ public:
      * The predicate
      * \return a pointer on a UnaryPred
      */
-    static UnaryPred::shared_ptr makeUnaryPred(std::string op, Predicate::shared_ptr predicate);
+    UnaryPred::shared_ptr makeUnaryPred(std::string op, Predicate::shared_ptr predicate);
     /*!
      * \brief Create a quantified predicate
      * \param op
@@ -266,9 +282,9 @@ public:
      * The body
      * \return a pointer on a QuantifiedPred
      */
-    static QuantifiedPred::shared_ptr makeQuantifiedPred(std::string op,
-                                                         std::vector<Expression::shared_ptr> variables,
-                                                         Instruction::shared_ptr body);
+    QuantifiedPred::shared_ptr makeQuantifiedPred(std::string op,
+                                                  std::vector<Expression::shared_ptr> variables,
+                                                  Instruction::shared_ptr body);
     /*!
      * \brief Create a binary predicate
      * \param left
@@ -279,9 +295,9 @@ public:
      * The right operand
      * \return a pointer on a BinaryPred
      */
-    static BinaryPred::shared_ptr makeBinaryPred(Predicate::shared_ptr left,
-                                                 std::string op,
-                                                 Predicate::shared_ptr right);
+    BinaryPred::shared_ptr makeBinaryPred(Predicate::shared_ptr left,
+                                          std::string op,
+                                          Predicate::shared_ptr right);
     // Operation
     /*!
      * \brief Create an operation
@@ -299,12 +315,12 @@ public:
      * The variable associated to the type of the operation
      * \return a pointer on an Operation
      */
-    static Operation::shared_ptr makeOperation(std::string name,
-                                               std::vector<Ident::shared_ptr> input_params,
-                                               std::vector<Ident::shared_ptr> output_params,
-                                               Predicate::shared_ptr precondition,
-                                               Instruction::shared_ptr body,
-                                               solver::Variable::shared_ptr var);
+    Operation::shared_ptr makeOperation(std::string name,
+                                        std::vector<Ident::shared_ptr> input_params,
+                                        std::vector<Ident::shared_ptr> output_params,
+                                        Predicate::shared_ptr precondition,
+                                        Instruction::shared_ptr body,
+                                        solver::Variable::shared_ptr var);
     // Instructions
 
     /*!
@@ -315,8 +331,8 @@ public:
      * The values to assign
      * \return a pointer on an Assignments
      */
-    static Assignments::shared_ptr makeAssignments(std::vector<Expression::shared_ptr> variables,
-                                                   std::vector<Expression::shared_ptr> values);
+    Assignments::shared_ptr makeAssignments(std::vector<Expression::shared_ptr> variables,
+                                            std::vector<Expression::shared_ptr> values);
     /*!
      * \brief Create a substitution of arity n
      * \param instructions
@@ -325,20 +341,20 @@ public:
      * The operator between the instructions
      * \return a pointer on a NarySub
      */
-    static NarySub::shared_ptr makeNarySub(std::vector<Instruction::shared_ptr> instructions,
-                                           std::string op);
+    NarySub::shared_ptr makeNarySub(std::vector<Instruction::shared_ptr> instructions,
+                                    std::string op);
     /*!
      * \brief Create a block
      * \param body
      * The body of the block
      * \return a pointer on a Block
      */
-    static Block::shared_ptr makeBlock(Instruction::shared_ptr body);
+    Block::shared_ptr makeBlock(Instruction::shared_ptr body);
     /*!
      * \brief Create a skip instruction
      * \return a pointer on a Skip
      */
-    static Skip::shared_ptr makeSkip();
+    Skip::shared_ptr makeSkip();
     /*!
      * \brief Create an assert instruction
      * \param condition
@@ -347,8 +363,8 @@ public:
      * The body of the assertion
      * \return a pointer on an Assertion
      */
-    static Assert::shared_ptr makeAssert(Predicate::shared_ptr condition,
-                                         Instruction::shared_ptr body);
+    Assert::shared_ptr makeAssert(Predicate::shared_ptr condition,
+                                  Instruction::shared_ptr body);
     /*!
      * \brief Create a conditional instruction
      * \param condition
@@ -359,9 +375,9 @@ public:
      * The alternative
      * \return a pointer on a Conditional
      */
-    static Conditional::shared_ptr makeIf(Predicate::shared_ptr condition,
-                                          Instruction::shared_ptr consequent,
-                                          Instruction::shared_ptr alternative);
+    Conditional::shared_ptr makeIf(Predicate::shared_ptr condition,
+                                   Instruction::shared_ptr consequent,
+                                   Instruction::shared_ptr alternative);
     /*!
      * \brief Create a select instruction
      * \param conditions
@@ -372,9 +388,9 @@ public:
      * The alternative
      * \return a pointer on a Select
      */
-    static Select::shared_ptr makeSelect(std::vector<Predicate::shared_ptr> conditions,
-                                         std::vector<Instruction::shared_ptr> consequences,
-                                         Instruction::shared_ptr alternative);
+    Select::shared_ptr makeSelect(std::vector<Predicate::shared_ptr> conditions,
+                                  std::vector<Instruction::shared_ptr> consequences,
+                                  Instruction::shared_ptr alternative);
     /*!
      * \brief Create a case instruction
      * \param value
@@ -387,10 +403,10 @@ public:
      * The alternative
      * \return a pointer on a Case
      */
-    static Case::shared_ptr makeCase(Expression::shared_ptr value,
-                                     std::vector<Expression::shared_ptr> choices,
-                                     std::vector<Instruction::shared_ptr> consequences,
-                                     Instruction::shared_ptr alternative);
+    Case::shared_ptr makeCase(Expression::shared_ptr value,
+                              std::vector<Expression::shared_ptr> choices,
+                              std::vector<Instruction::shared_ptr> consequences,
+                              Instruction::shared_ptr alternative);
     /*!
      * \brief Create an any instruction
      * \param variables
@@ -401,9 +417,9 @@ public:
      * The body of the instruction
      * \return a pointer on an Any
      */
-    static Any::shared_ptr makeAny(std::vector<Expression::shared_ptr> variables,
-                                   Predicate::shared_ptr predicate,
-                                   Instruction::shared_ptr body);
+    Any::shared_ptr makeAny(std::vector<Expression::shared_ptr> variables,
+                            Predicate::shared_ptr predicate,
+                            Instruction::shared_ptr body);
     /*!
      * \brief Create a let instruction
      * \param variables
@@ -414,9 +430,9 @@ public:
      * The body of the instruction
      * \return a pointer on the Let
      */
-    static Let::shared_ptr makeLet(std::vector<Expression::shared_ptr> variables,
-                                   std::vector<Expression::shared_ptr> values,
-                                   Instruction::shared_ptr body);
+    Let::shared_ptr makeLet(std::vector<Expression::shared_ptr> variables,
+                            std::vector<Expression::shared_ptr> values,
+                            Instruction::shared_ptr body);
     /*!
      * \brief Create a becomes in instruction
      * \param variables
@@ -425,8 +441,8 @@ public:
      * The set containing the identifiers
      * \return a pointer on the BecomesIn
      */
-    static BecomesIn::shared_ptr makeBecomesIn(std::vector<Expression::shared_ptr> variables,
-                                               Expression::shared_ptr set);
+    BecomesIn::shared_ptr makeBecomesIn(std::vector<Expression::shared_ptr> variables,
+                                        Expression::shared_ptr set);
     /*!
      * \brief Create a becomes such that instruction
      * \param variables
@@ -435,8 +451,8 @@ public:
      * The predicate
      * \return a pointer on the BecomesSuchThat
      */
-    static BecomesSuchThat::shared_ptr makeBecomesSuchThat(std::vector<Expression::shared_ptr> variables,
-                                                           Predicate::shared_ptr predicate);
+    BecomesSuchThat::shared_ptr makeBecomesSuchThat(std::vector<Expression::shared_ptr> variables,
+                                                    Predicate::shared_ptr predicate);
     /*!
      * \brief Create a var in instruction
      * \param variables
@@ -445,8 +461,8 @@ public:
      * The body of the instruction
      * \return a pointer on the VarIn
      */
-    static VarIn::shared_ptr makeVarIn(std::vector<Expression::shared_ptr> variables,
-                                       Instruction::shared_ptr body);
+    VarIn::shared_ptr makeVarIn(std::vector<Expression::shared_ptr> variables,
+                                Instruction::shared_ptr body);
     /*!
      * \brief Create an operation call instruction
      * \param name
@@ -457,9 +473,9 @@ public:
      * The output arguments
      * \return a pointer on the OperationCall
      */
-    static OperationCall::shared_ptr makeOperationCall(std::string name,
-                                                       std::vector<Expression::shared_ptr> inputs,
-                                                       std::vector<Expression::shared_ptr> outputs);
+    OperationCall::shared_ptr makeOperationCall(std::string name,
+                                                std::vector<Expression::shared_ptr> inputs,
+                                                std::vector<Expression::shared_ptr> outputs);
     /*!
      * \brief Create a while instruction
      * \param condition
@@ -472,10 +488,17 @@ public:
      * The variant of the loop
      * \return a pointer on the Loop
      */
-    static Loop::shared_ptr makeLoop(Predicate::shared_ptr condition,
-                                     Instruction::shared_ptr body,
-                                     Predicate::shared_ptr invariant,
-                                     Expression::shared_ptr variant);
+    Loop::shared_ptr makeLoop(Predicate::shared_ptr condition,
+                              Instruction::shared_ptr body,
+                              Predicate::shared_ptr invariant,
+                              Expression::shared_ptr variant);
+
+private:
+    /*!
+     * \brief The allocator taking its memory from the arena of the session in
+     * which the factory was instanciated
+     */
+    tools::ArenaAllocator<std::byte> allocator_;
 };
 }
 
@@ -26,11 +26,11 @@
 #define EXPRESSION_H
 
 #include <memory>
-#include <set>
 
 #include "belement.h"
 #include "bxmlposition.h"
 #include "btypes.h"
+#include "smallvector.h"
 #include "vargen.h"
 
 namespace belem
@@ -41,13 +41,18 @@ namespace belem
 class Expression : public AbstractBElement
 {
 public:
+    /*!
+     * \brief The positions of an expression, most expressions having a single
+     * one
+     */
+    typedef tools::SmallVector<bxml::Position::shared_ptr, 2> Positions;
     /*!
      * \brief Associate a variable to the expression
      * \param positions
      * The positions of the expression in a bxml file
      *
      */
-    Expression(std::set<bxml::Position::shared_ptr> positions);
+    Expression(Positions positions);
     /*!
      * \brief A shared_ptr on an Expression
      */
@@ -66,19 +71,17 @@ public:
      * \brief An accessor on the positions of the expression
      * \return the positions of the expression
      */
-    virtual std::set<bxml::Position::shared_ptr> getPositions()
+    virtual Positions getPositions()
     {
         return positions_;
     }
     /*!
-     * \brief Add a position to the expression
+     * \brief Add a position to the expression. The expressions shared by
+     * several proof obligations may be given positions by several threads.
      * \param position
      * The position to add
      */
-    virtual void addPosition(bxml::Position::shared_ptr position)
-    {
-        positions_.insert(position);
-    }
+    virtual void addPosition(bxml::Position::shared_ptr position);
     /*!
      * \brief Clear the position of an expression
      */
@@ -94,7 +97,7 @@ private:
     /*!
      * \brief The positions of the variables in a bxml file
      */
-    std::set<bxml::Position::shared_ptr> positions_;
+    Positions positions_;
 };
 }
 
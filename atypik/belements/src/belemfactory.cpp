@@ -24,86 +24,109 @@
  */
 #include "../include/belemfactory.h"
 
-using std::make_shared;
+#include <utility>
+
+#include "arena.h"
+#include "session.h"
+
+using std::allocate_shared;
+using std::shared_ptr;
 using std::string;
 using std::vector;
 
 namespace belem {
 
+namespace {
+// The elements are allocated in the arena of the session of the factory. The
+// allocator is rebound and copied once into the control block of each
+// element, which keeps the arena alive
+template <class T, class... Args>
+shared_ptr<T> make(const tools::ArenaAllocator<std::byte> &allocator,
+                   Args &&...args) {
+  return allocate_shared<T>(allocator, std::forward<Args>(args)...);
+}
+}  // namespace
+
+Factory::Factory() : allocator_(solver::Session::getCurrent()->getArena()) {}
+
+const tools::ArenaAllocator<std::byte> &Factory::getAllocator() const {
+  return allocator_;
+}
+
 // Expressions
 
 BinaryExp::shared_ptr Factory::makeBinaryExp(
     Expression::shared_ptr left, string op, Expression::shared_ptr right,
     bxml::Position::shared_ptr position) {
-  return make_shared<BinaryExp>(left, op, right, position);
+  return make<BinaryExp>(allocator_, left, op, right, position);
 }
 
 BooleanExpression::shared_ptr Factory::makeBooleanExp(
     Predicate::shared_ptr predicate, bxml::Position::shared_ptr position) {
-  return make_shared<BooleanExpression>(predicate, position);
+  return make<BooleanExpression>(allocator_, predicate, position);
 }
 
 BBool::shared_ptr Factory::makeBool(std::string value,
                                     bxml::Position::shared_ptr position) {
-  return make_shared<BBool>(value, position);
+  return make<BBool>(allocator_, value, position);
 }
 
 BInteger::shared_ptr Factory::makeInt(string value,
                                       bxml::Position::shared_ptr position) {
-  return make_shared<BInteger>(value, position);
+  return make<BInteger>(allocator_, value, position);
 }
 
 BReal::shared_ptr Factory::makeReal(string value,
                                     bxml::Position::shared_ptr position) {
-  return make_shared<BReal>(value, position);
+  return make<BReal>(allocator_, value, position);
 }
 
 BString::shared_ptr Factory::makeString(string value,
                                         bxml::Position::shared_ptr position) {
-  return make_shared<BString>(value, position);
+  return make<BString>(allocator_, value, position);
 }
 
 Ident::shared_ptr Factory::makeIdent(std::string value,
                                      bxml::Position::shared_ptr position) {
-  return make_shared<Ident>(value, position);
+  return make<Ident>(allocator_, value, position);
 }
 
 Set::shared_ptr Factory::makeSet(Ident::shared_ptr id,
                                  vector<Expression::shared_ptr> content,
                                  bxml::Position::shared_ptr position) {
-  return make_shared<Set>(id, content, position);
+  return make<Set>(allocator_, id, content, position);
 }
 
 UnaryExp::shared_ptr Factory::makeUnaryExp(
     string op, Expression::shared_ptr expression,
     bxml::Position::shared_ptr position) {
-  return make_shared<UnaryExp>(op, expression, position);
+  return make<UnaryExp>(allocator_, op, expression, position);
 }
 
 NaryExp::shared_ptr Factory::makeNaryExp(
     vector<Expression::shared_ptr> operands, string op,
     bxml::Position::shared_ptr position) {
-  return make_shared<NaryExp>(operands, op, position);
+  return make<NaryExp>(allocator_, operands, op, position);
 }
 
 QuantifiedExp::shared_ptr Factory::makeQuantifiedExp(
     string type, vector<Expression::shared_ptr> identifiers,
     Predicate::shared_ptr predicate, Expression::shared_ptr expression,
     bxml::Position::shared_ptr position) {
-  return make_shared<QuantifiedExp>(type, identifiers, predicate, expression,
-                                    position);
+  return make<QuantifiedExp>(allocator_, type, identifiers, predicate,
+                             expression, position);
 }
 
 QuantifiedSet::shared_ptr Factory::makeQuantifiedSet(
     vector<Expression::shared_ptr> expression, Predicate::shared_ptr predicate,
     bxml::Position::shared_ptr position) {
-  return make_shared<QuantifiedSet>(expression, predicate, position);
+  return make<QuantifiedSet>(allocator_, expression, predicate, position);
 }
 
 Valuation::shared_ptr Factory::makeValuation(
     Expression::shared_ptr variable, Expression::shared_ptr value,
     bxml::Position::shared_ptr position) {
-  return make_shared<Valuation>(variable, value, position);
+  return make<Valuation>(allocator_, variable, value, position);
 }
 
 // Predicates
@@ -111,29 +134,29 @@ Valuation::shared_ptr Factory::makeValuation(
 Comparison::shared_ptr Factory::makeComparison(Expression::shared_ptr left,
                                                string op,
                                                Expression::shared_ptr right) {
-  return make_shared<Comparison>(left, op, right);
+  return make<Comparison>(allocator_, left, op, right);
 }
 
 NaryPred::shared_ptr Factory::makeNaryPred(
     vector<Predicate::shared_ptr> clauses, string op) {
-  return make_shared<NaryPred>(clauses, op);
+  return make<NaryPred>(allocator_, clauses, op);
 }
 
 UnaryPred::shared_ptr Factory::makeUnaryPred(string op,
                                              Predicate::shared_ptr predicate) {
-  return make_shared<UnaryPred>(op, predicate);
+  return make<UnaryPred>(allocator_, op, predicate);
 }
 
 QuantifiedPred::shared_ptr Factory::makeQuantifiedPred(
     string op, vector<Expression::shared_ptr> variables,
     Predicate::shared_ptr body) {
-  return make_shared<QuantifiedPred>(op, variables, body);
+  return make<QuantifiedPred>(allocator_, op, variables, body);
 }
 
 BinaryPred::shared_ptr Factory::makeBinaryPred(Predicate::shared_ptr left,
                                                string op,
                                                Predicate::shared_ptr right) {
-  return make_shared<BinaryPred>(left, op, right);
+  return make<BinaryPred>(allocator_, left, op, right);
 }
 
 // Operation
@@ -143,8 +166,8 @@ Operation::shared_ptr Factory::makeOperation(
     std::vector<Ident::shared_ptr> output_params,
     Predicate::shared_ptr precondition, Instruction::shared_ptr body,
     solver::Variable::shared_ptr var) {
-  return make_shared<Operation>(name, input_params, output_params, precondition,
-                                body, var);
+  return make<Operation>(allocator_, name, input_params, output_params,
+                         precondition, body, var);
 }
 
 // Instructions
@@ -152,83 +175,83 @@ Operation::shared_ptr Factory::makeOperation(
 Assignments::shared_ptr Factory::makeAssignments(
     vector<Expression::shared_ptr> variables,
     vector<Expression::shared_ptr> values) {
-  return make_shared<Assignments>(variables, values);
+  return make<Assignments>(allocator_, variables, values);
 }
 
 NarySub::shared_ptr Factory::makeNarySub(
     vector<Instruction::shared_ptr> instructions, string op) {
-  return make_shared<NarySub>(instructions, op);
+  return make<NarySub>(allocator_, instructions, op);
 }
 
 Block::shared_ptr Factory::makeBlock(Instruction::shared_ptr body) {
-  return make_shared<Block>(body);
+  return make<Block>(allocator_, body);
 }
 
-Skip::shared_ptr Factory::makeSkip() { return make_shared<Skip>(); }
+Skip::shared_ptr Factory::makeSkip() { return make<Skip>(allocator_); }
 
 Assert::shared_ptr Factory::makeAssert(Predicate::shared_ptr condition,
                                        Instruction::shared_ptr body) {
-  return make_shared<Assert>(condition, body);
+  return make<Assert>(allocator_, condition, body);
 }
 
 Conditional::shared_ptr Factory::makeIf(Predicate::shared_ptr condition,
                                         Instruction::shared_ptr consequent,
                                         Instruction::shared_ptr alternative) {
-  return make_shared<Conditional>(condition, consequent, alternative);
+  return make<Conditional>(allocator_, condition, consequent, alternative);
 }
 
 Select::shared_ptr Factory::makeSelect(
     vector<Predicate::shared_ptr> conditions,
     vector<Instruction::shared_ptr> consequences,
     Instruction::shared_ptr alternative) {
-  return make_shared<Select>(conditions, consequences, alternative);
+  return make<Select>(allocator_, conditions, consequences, alternative);
 }
 
 Case::shared_ptr Factory::makeCase(Expression::shared_ptr value,
                                    vector<Expression::shared_ptr> choices,
                                    vector<Instruction::shared_ptr> consequences,
                                    Instruction::shared_ptr alternative) {
-  return make_shared<Case>(value, choices, consequences, alternative);
+  return make<Case>(allocator_, value, choices, consequences, alternative);
 }
 
 Any::shared_ptr Factory::makeAny(vector<Expression::shared_ptr> variables,
                                  Predicate::shared_ptr predicate,
                                  Instruction::shared_ptr body) {
-  return make_shared<Any>(variables, predicate, body);
+  return make<Any>(allocator_, variables, predicate, body);
 }
 
 Let::shared_ptr Factory::makeLet(vector<Expression::shared_ptr> variables,
                                  vector<Expression::shared_ptr> values,
                                  Instruction::shared_ptr body) {
-  return make_shared<Let>(variables, values, body);
+  return make<Let>(allocator_, variables, values, body);
 }
 
 BecomesIn::shared_ptr Factory::makeBecomesIn(
     vector<Expression::shared_ptr> variables, Expression::shared_ptr set) {
-  return make_shared<BecomesIn>(variables, set);
+  return make<BecomesIn>(allocator_, variables, set);
 }
 
 BecomesSuchThat::shared_ptr Factory::makeBecomesSuchThat(
     vector<Expression::shared_ptr> variables, Predicate::shared_ptr predicate) {
-  return make_shared<BecomesSuchThat>(variables, predicate);
+  return make<BecomesSuchThat>(allocator_, variables, predicate);
 }
 
 VarIn::shared_ptr Factory::makeVarIn(vector<Expression::shared_ptr> variables,
                                      Instruction::shared_ptr body) {
-  return make_shared<VarIn>(variables, body);
+  return make<VarIn>(allocator_, variables, body);
 }
 
 OperationCall::shared_ptr Factory::makeOperationCall(
     string name, vector<Expression::shared_ptr> inputs,
     vector<Expression::shared_ptr> outputs) {
-  return make_shared<OperationCall>(name, inputs, outputs);
+  return make<OperationCall>(allocator_, name, inputs, outputs);
 }
 
 Loop::shared_ptr Factory::makeLoop(Predicate::shared_ptr condition,
                                    Instruction::shared_ptr body,
                                    Predicate::shared_ptr invariant,
                                    Expression::shared_ptr variant) {
-  return make_shared<Loop>(condition, body, invariant, variant);
+  return make<Loop>(allocator_, condition, body, invariant, variant);
 }
 
 }  // namespace belem
@@ -24,8 +24,30 @@
  */
 #include "expression.h"
 
+#include <functional>
+#include <mutex>
+
 using namespace belem;
-using std::set;
+using std::hash;
+using std::lock_guard;
+using std::move;
+using std::mutex;
+
+namespace {
+// A mutex per expression would be too costly, so the expressions share a few
+// mutexes protecting their positions
+const size_t positions_mutexes_count = 64;
+mutex positions_mutexes[positions_mutexes_count];
+}
+
+Expression::Expression(Positions positions):
+    var_(solver::VarGenerator::getNewVariable()), positions_(move(positions)) {}
 
-Expression::Expression(std::set<bxml::Position::shared_ptr> positions):
-    var_(solver::VarGenerator::getNewVariable()), positions_(positions) {}
+void Expression::addPosition(bxml::Position::shared_ptr position)
+{
+    size_t index = hash<Expression *>()(this) % positions_mutexes_count;
+    lock_guard<mutex> lock(positions_mutexes[index]);
+    // Each position is built for a single occurrence, so it cannot be
+    // recorded twice
+    positions_.push_back(position);
+}
@@ -28,9 +28,14 @@
 #include "tinyxml2.h"
 
 #include <memory>
+#include <string>
 
 namespace bxml
 {
+/*!
+ * \brief The Position class locates an element in a bxml file. It is
+ * trivially destructible, so that the positions can be allocated in an arena.
+ */
 class Position
 {
 public:
@@ -66,8 +71,8 @@ public:
      */
     int getSpan();
     /*!
-     * \brief An accessor on the tag
-     * \return the tag
+     * \brief An accessor on the tag, read from the element
+     * \return the tag, empty if the element has none
      */
     std::string getTag();
     /*!
@@ -89,10 +94,6 @@ private:
      * \brief The span
      */
     int span_;
-    /*!
-     * \brief The tag
-     */
-    std::string tag_;
     /*!
      * \brief A pointer on the element in the file
      */
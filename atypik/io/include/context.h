@@ -62,18 +62,19 @@ public:
     /*!
      * \brief Push an identifier into the context. If the identifier
      * is already present, its value is overriden
+     * \param symbol
+     * The symbol of the name of the identifier
      * \param identifier
      * The identifier to push
      */
-    void push(belem::Expression::shared_ptr identifier);
+    void push(int symbol, belem::Expression::shared_ptr identifier);
     /*!
      * \brief Fetch an identifier in the context
-     * \param identifier
-     * The identifier to fetch
-     * \return the identifier if it is in the context. Raises an exception
-     * otherwise
+     * \param symbol
+     * The symbol of the name of the identifier to fetch
+     * \return the identifier if it is in the context, nullptr otherwise
      */
-    belem::Expression::shared_ptr get(std::string identifier);
+    belem::Expression::shared_ptr find(int symbol) const;
     /*!
      * \brief Check if the set name is in the context
      * \param name
@@ -111,6 +112,12 @@ public:
      * The models
      */
     void SetModels(std::vector<solver::Model::shared_ptr> model);
+    /*!
+     * \brief Set the model shared by the models of the context
+     * \param model
+     * The shared model
+     */
+    void setBaseModel(solver::Model::shared_ptr model);
     /*!
      * \brief An accessor on the expressions in the context
      * \return the expressions in the context
@@ -126,17 +133,27 @@ public:
      * \return a shared pointer on the models in the context
      */
     std::vector<solver::Model::shared_ptr> getModels();
+    /*!
+     * \brief An accessor on the model shared by the models of the context
+     * \return the shared model, or nullptr if the models are independent
+     */
+    solver::Model::shared_ptr getBaseModel();
     /*!
      * \brief A shared_ptr on a context
      */
     typedef std::shared_ptr<Context> shared_ptr;
     /*!
-     * \brief Copy the current context
+     * \brief Copy the identifiers and the sets of the current context. The
+     * scopes of identifiers are shared by the copies, so that the copy does
+     * not depend on the number of identifiers.
      * \return a shared pointer on the new context
      */
     Context::shared_ptr copy_shared_ptr();
     /*!
-     * \brief Merge the current context with another one
+     * \brief Merge the identifiers and the sets of the current context with
+     * the ones of another context. The identifiers of the current context
+     * hide the ones of the other context with the same name. The scopes of
+     * both contexts are shared by the merged one.
      * \param context
      * The other context
      * \return the merged context
@@ -152,15 +169,28 @@ public:
 
 private:
     /*!
-     * \brief A map of shape id -> {exp1, ..., expn}
-     * where id is a string representing an identifier and
-     * {exp1, ..., expn} the corresponding expressions
+     * \brief A scope of identifiers associated to the symbol of their name
+     */
+    typedef std::unordered_map<int, belem::Expression::shared_ptr> Scope;
+    /*!
+     * \brief The identifiers pushed since the last copy of the context
      */
-    std::unordered_map<std::string, std::vector<belem::Expression::shared_ptr>> identifiers_;
+    Scope identifiers_;
+    /*!
+     * \brief The scopes of identifiers of the context, which are not modified
+     * any more and are shared by its copies. An identifier of a scope hides the
+     * identifiers of the previous scopes with the same name.
+     */
+    std::vector<std::shared_ptr<const Scope>> scopes_;
     /*!
      * \brief Contains the sets in the context
      */
     std::unordered_set<std::string> sets_;
+    /*!
+     * \brief Move the identifiers pushed since the last copy into a shared
+     * scope, if any
+     */
+    void freeze();
     /*!
      * \brief The parsed expressions
      */
@@ -173,6 +203,10 @@ private:
      * \brief The state of the models in the context
      */
     std::vector<solver::Model::shared_ptr> models_;
+    /*!
+     * \brief The model shared by the models of the context, if any
+     */
+    solver::Model::shared_ptr base_model_;
 };
 }
 
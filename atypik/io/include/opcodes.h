@@ -0,0 +1,338 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#ifndef OPCODES_H
+#define OPCODES_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace genericparser
+{
+
+/*!
+ * \brief The XML tags of the expressions, instructions and predicates
+ */
+enum class Tag : std::uint8_t {
+    Unknown,
+    // Expressions
+    Id, BooleanLiteral, IntegerLiteral, RealLiteral, StringLiteral, BinaryExp,
+    UnaryExp, BooleanExp, NaryExp, Set, EmptySeq, EmptySet, QuantifiedSet,
+    QuantifiedExp, Valuation,
+    // Instructions
+    NarySub, AssignementSub, BlocSub, Skip, AssertSub, IfSub, Select, CaseSub,
+    AnySub, LetSub, BecomesIn, BecomesSuchThat, VarIn, OperationCall, While,
+    // Predicates
+    UnaryPred, NaryPred, ExpComparison, QuantifiedPred, BinaryPred
+};
+
+/*!
+ * \brief The operators of the binary and unary expressions and of the
+ * comparisons. An operator which is both unary and binary, such as -i, has a
+ * single opcode
+ */
+enum class Operator : std::uint8_t {
+    Unknown,
+    // Arithmetic
+    IntPlus, IntMinus, IntTimes, IntPower, IntDivide, Modulo, RealPlus,
+    RealMinus, RealTimes, RealPower, RealDivide, FloatPlus, FloatMinus,
+    FloatTimes, FloatDivide, Interval, Successor, Predecessor, Real, Floor,
+    Ceiling, IntMax, IntMin, RealMax, RealMin,
+    // Sets
+    CartesianProduct, SetDifference, Intersection, Union, Cardinal, Powerset,
+    Powerset1, FinitePowerset, FinitePowerset1, GeneralizedUnion,
+    GeneralizedIntersection,
+    // Sequences
+    Concatenation, InsertFront, InsertTail, RestrictFront, RestrictTail,
+    Sequences, Sequences1, InjectiveSequences, InjectiveSequences1,
+    Permutations, Size, First, Last, Front, Tail, Reverse,
+    GeneralizedConcatenation,
+    // Relations and functions
+    Maplet, Comma, Relations, FirstProjection, SecondProjection, Composition,
+    DirectProduct, ParallelProduct, Iteration, Image, DomainSubtraction,
+    DomainRestriction, RangeRestriction, RangeSubtraction, Overwrite,
+    TotalFunction, PartialFunction, PartialInjection, TotalInjection,
+    PartialSurjection, TotalSurjection, TotalBijection, Evaluation, Identity,
+    Inverse, Closure, Closure1, Domain, Range, Fnc, Rel,
+    // Comparisons
+    Membership, NonMembership, Equal, NotEqual, IntLessEqual, IntGreaterEqual,
+    IntLess, IntGreater, RealLessEqual, RealGreaterEqual, RealLess,
+    RealGreater, Inclusion
+};
+
+namespace detail
+{
+
+/*!
+ * \brief An entry of a lookup table, associating a name to its code
+ */
+template <typename Code>
+struct Entry {
+    std::string_view name;
+    Code code;
+};
+
+/*!
+ * \brief Sort the entries of a lookup table by name, at compile time
+ */
+template <typename Code, std::size_t N>
+constexpr std::array<Entry<Code>, N> sortEntries(std::array<Entry<Code>, N> entries) {
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry<Code>& a, const Entry<Code>& b) { return a.name < b.name; });
+    return entries;
+}
+
+/*!
+ * \brief Check that the names of sorted entries are all different
+ */
+template <typename Code, std::size_t N>
+constexpr bool areUnique(const std::array<Entry<Code>, N>& entries) {
+    return std::adjacent_find(entries.begin(), entries.end(),
+                              [](const Entry<Code>& a, const Entry<Code>& b) {
+                                  return a.name == b.name;
+                              }) == entries.end();
+}
+
+/*!
+ * \brief Find the code of a name by binary search in sorted entries
+ * \return the code of the name, Code::Unknown if it is not in the entries
+ */
+template <typename Code, std::size_t N>
+constexpr Code lookup(const std::array<Entry<Code>, N>& entries, std::string_view name) {
+    auto found = std::lower_bound(entries.begin(), entries.end(), name,
+                                  [](const Entry<Code>& entry, std::string_view name) {
+                                      return entry.name < name;
+                                  });
+    if (found != entries.end() and found->name == name)
+        return found->code;
+    return Code::Unknown;
+}
+
+/*!
+ * \brief Index the names of a lookup table by code, at compile time. The codes
+ * of the entries are 1 to N, 0 being Code::Unknown which has an empty name
+ */
+template <typename Code, std::size_t N>
+constexpr std::array<std::string_view, N + 1> indexNames(const std::array<Entry<Code>, N>& entries) {
+    std::array<std::string_view, N + 1> names{};
+    for (const Entry<Code>& entry : entries)
+        names[static_cast<std::size_t>(entry.code)] = entry.name;
+    return names;
+}
+
+inline constexpr auto tags = sortEntries(std::to_array<Entry<Tag>>({
+    {"Id", Tag::Id},
+    {"Boolean_Literal", Tag::BooleanLiteral},
+    {"Integer_Literal", Tag::IntegerLiteral},
+    {"Real_Literal", Tag::RealLiteral},
+    {"String_Literal", Tag::StringLiteral},
+    {"Binary_Exp", Tag::BinaryExp},
+    {"Unary_Exp", Tag::UnaryExp},
+    {"Boolean_Exp", Tag::BooleanExp},
+    {"Nary_Exp", Tag::NaryExp},
+    {"Set", Tag::Set},
+    {"EmptySeq", Tag::EmptySeq},
+    {"EmptySet", Tag::EmptySet},
+    {"Quantified_Set", Tag::QuantifiedSet},
+    {"Quantified_Exp", Tag::QuantifiedExp},
+    {"Valuation", Tag::Valuation},
+    {"Nary_Sub", Tag::NarySub},
+    {"Assignement_Sub", Tag::AssignementSub},
+    {"Bloc_Sub", Tag::BlocSub},
+    {"Skip", Tag::Skip},
+    {"Assert_Sub", Tag::AssertSub},
+    {"If_Sub", Tag::IfSub},
+    {"Select", Tag::Select},
+    {"Case_Sub", Tag::CaseSub},
+    {"ANY_Sub", Tag::AnySub},
+    {"LET_Sub", Tag::LetSub},
+    {"Becomes_In", Tag::BecomesIn},
+    {"Becomes_Such_That", Tag::BecomesSuchThat},
+    {"VAR_IN", Tag::VarIn},
+    {"Operation_Call", Tag::OperationCall},
+    {"While", Tag::While},
+    {"Unary_Pred", Tag::UnaryPred},
+    {"Nary_Pred", Tag::NaryPred},
+    {"Exp_Comparison", Tag::ExpComparison},
+    {"Quantified_Pred", Tag::QuantifiedPred},
+    {"Binary_Pred", Tag::BinaryPred},
+}));
+
+inline constexpr auto operators = sortEntries(std::to_array<Entry<Operator>>({
+    {"+i", Operator::IntPlus},
+    {"-i", Operator::IntMinus},
+    {"*i", Operator::IntTimes},
+    {"**i", Operator::IntPower},
+    {"/i", Operator::IntDivide},
+    {"mod", Operator::Modulo},
+    {"+r", Operator::RealPlus},
+    {"-r", Operator::RealMinus},
+    {"*r", Operator::RealTimes},
+    {"**r", Operator::RealPower},
+    {"/r", Operator::RealDivide},
+    {"+f", Operator::FloatPlus},
+    {"-f", Operator::FloatMinus},
+    {"*f", Operator::FloatTimes},
+    {"/f", Operator::FloatDivide},
+    {"..", Operator::Interval},
+    {"succ", Operator::Successor},
+    {"pred", Operator::Predecessor},
+    {"real", Operator::Real},
+    {"floor", Operator::Floor},
+    {"ceiling", Operator::Ceiling},
+    {"imax", Operator::IntMax},
+    {"imin", Operator::IntMin},
+    {"rmax", Operator::RealMax},
+    {"rmin", Operator::RealMin},
+    {"*s", Operator::CartesianProduct},
+    {"-s", Operator::SetDifference},
+    {"/\\", Operator::Intersection},
+    {"\\/", Operator::Union},
+    {"card", Operator::Cardinal},
+    {"POW", Operator::Powerset},
+    {"POW1", Operator::Powerset1},
+    {"FIN", Operator::FinitePowerset},
+    {"FIN1", Operator::FinitePowerset1},
+    {"union", Operator::GeneralizedUnion},
+    {"inter", Operator::GeneralizedIntersection},
+    {"^", Operator::Concatenation},
+    {"->", Operator::InsertFront},
+    {"<-", Operator::InsertTail},
+    {"/|\\", Operator::RestrictFront},
+    {"\\|/", Operator::RestrictTail},
+    {"seq", Operator::Sequences},
+    {"seq1", Operator::Sequences1},
+    {"iseq", Operator::InjectiveSequences},
+    {"iseq1", Operator::InjectiveSequences1},
+    {"perm", Operator::Permutations},
+    {"size", Operator::Size},
+    {"first", Operator::First},
+    {"last", Operator::Last},
+    {"front", Operator::Front},
+    {"tail", Operator::Tail},
+    {"rev", Operator::Reverse},
+    {"conc", Operator::GeneralizedConcatenation},
+    {"|->", Operator::Maplet},
+    {",", Operator::Comma},
+    {"<->", Operator::Relations},
+    {"prj1", Operator::FirstProjection},
+    {"prj2", Operator::SecondProjection},
+    {";", Operator::Composition},
+    {"><", Operator::DirectProduct},
+    {"||", Operator::ParallelProduct},
+    {"iterate", Operator::Iteration},
+    {"[", Operator::Image},
+    {"<<|", Operator::DomainSubtraction},
+    {"<|", Operator::DomainRestriction},
+    {"|>", Operator::RangeRestriction},
+    {"|>>", Operator::RangeSubtraction},
+    {"<+", Operator::Overwrite},
+    {"-->", Operator::TotalFunction},
+    {"+->", Operator::PartialFunction},
+    {">+>", Operator::PartialInjection},
+    {">->", Operator::TotalInjection},
+    {"+->>", Operator::PartialSurjection},
+    {"-->>", Operator::TotalSurjection},
+    {">->>", Operator::TotalBijection},
+    {"(", Operator::Evaluation},
+    {"id", Operator::Identity},
+    {"~", Operator::Inverse},
+    {"closure", Operator::Closure},
+    {"closure1", Operator::Closure1},
+    {"dom", Operator::Domain},
+    {"ran", Operator::Range},
+    {"fnc", Operator::Fnc},
+    {"rel", Operator::Rel},
+    {":", Operator::Membership},
+    {"/:", Operator::NonMembership},
+    {"=", Operator::Equal},
+    {"/=", Operator::NotEqual},
+    {"<=i", Operator::IntLessEqual},
+    {">=i", Operator::IntGreaterEqual},
+    {"<i", Operator::IntLess},
+    {">i", Operator::IntGreater},
+    {"<=r", Operator::RealLessEqual},
+    {">=r", Operator::RealGreaterEqual},
+    {"<r", Operator::RealLess},
+    {">r", Operator::RealGreater},
+    {"<:", Operator::Inclusion},
+}));
+
+static_assert(areUnique(tags), "A tag is declared twice");
+static_assert(areUnique(operators), "An operator is declared twice");
+
+inline constexpr auto tag_names = indexNames(tags);
+inline constexpr auto operator_names = indexNames(operators);
+
+}
+
+/*!
+ * \brief Compute the opcode of an XML tag
+ * \param tag
+ * The name of the tag
+ * \return the opcode of the tag, Tag::Unknown if the tag is unknown
+ */
+constexpr Tag computeTag(std::string_view tag) {
+    return detail::lookup(detail::tags, tag);
+}
+
+/*!
+ * \brief Compute the opcode of an operator
+ * \param op
+ * The name of the operator
+ * \return the opcode of the operator, Operator::Unknown if the operator is
+ * unknown
+ */
+constexpr Operator computeOperator(std::string_view op) {
+    return detail::lookup(detail::operators, op);
+}
+
+/*!
+ * \brief The name of an XML tag
+ * \param tag
+ * The opcode of the tag
+ * \return the name of the tag, with a static storage duration, empty for
+ * Tag::Unknown
+ */
+constexpr std::string_view getName(Tag tag) {
+    return detail::tag_names[static_cast<std::size_t>(tag)];
+}
+
+/*!
+ * \brief The name of an operator
+ * \param op
+ * The opcode of the operator
+ * \return the name of the operator, with a static storage duration, empty for
+ * Operator::Unknown
+ */
+constexpr std::string_view getName(Operator op) {
+    return detail::operator_names[static_cast<std::size_t>(op)];
+}
+
+}
+
+#endif // OPCODES_H
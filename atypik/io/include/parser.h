@@ -25,7 +25,9 @@
 #ifndef PARSER_H
 #define PARSER_H
 
+#include <array>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <tinyxml2.h>
@@ -35,6 +37,8 @@
 #include "context.h"
 #include "machinetypes.h"
 #include "solverfactory.h"
+#include "symboltable.h"
+#include "typingrules.h"
 
 #include <iostream>
 
@@ -88,6 +92,17 @@ public:
      * \brief Disable multi threading for pog files
      */
     void disableMultiThread();
+    /*!
+     * \brief Enable incremental solving for pog files. The Define model is
+     * not merged into the model of each proof obligation but shared by them.
+     */
+    void enableIncrementalSolving();
+    /*!
+     * \brief Enable the seeding of the proof obligations models for pog
+     * files. The Define model is solved once and not merged into the model of
+     * each proof obligation.
+     */
+    void enableDefinesSeeding();
 
 
 protected:
@@ -95,10 +110,28 @@ protected:
      * \brief A boolean telling if multi thread is enable or not
      */
     bool enable_multi_thread_ = true;
+    /*!
+     * \brief A boolean telling if incremental solving is enable or not
+     */
+    bool enable_incremental_solving_ = false;
+    /*!
+     * \brief A boolean telling if the seeding of the models is enable or not
+     */
+    bool enable_defines_seeding_ = false;
     /*!
      * \brief The global context containing the identifiers in the sets
      */
     Context::shared_ptr global_context_ = std::make_shared<Context>(true);
+    /*!
+     * \brief The mutex protecting the global context, shared by the copies of
+     * the parser parsing concurrently
+     */
+    std::shared_ptr<std::mutex> global_context_mutex_ = std::make_shared<std::mutex>();
+    /*!
+     * \brief The symbols of the names of the identifiers, shared by the copies
+     * of the parser
+     */
+    SymbolTable::shared_ptr symbols_ = std::make_shared<SymbolTable>();
     /*!
      * \brief The expressions marked as sequences associated to their type
      */
@@ -115,6 +148,11 @@ protected:
      * \brief The parsed expressions
      */
     std::unordered_set<belem::Expression::shared_ptr> expressions_;
+    /*!
+     * \brief The expressions parsed before the parser was copied, which are
+     * read concurrently by the copies and not declared again, if any
+     */
+    const std::unordered_set<belem::Expression::shared_ptr> *shared_expressions_ = nullptr;
     /*!
      * \brief The parsed operations associated to their name
      */
@@ -123,6 +161,13 @@ protected:
      * \brief An instance of the solver factory
      */
     solver::Factory s_factory_;
+    /*!
+     * \brief An instance of the B elements factory, allocating in the arena
+     * of the session resolved once when the parser is instanciated. The
+     * copies of the parser share it, the workers being bound to the same
+     * session.
+     */
+    belem::Factory b_factory_;
     /*!
      * \brief The prefix to add to the identifiers (if the parsed machine is
      * referenced and instanciated)
@@ -795,6 +840,34 @@ protected:
      */
     std::pair<solver::Variable::shared_ptr, solver::Variable::shared_ptr> addRelationTypeConstraint(solver::Model::shared_ptr model,
                                                                                                     belem::Expression::shared_ptr realtion);
+    /*!
+     * \brief Add the constraints of a typing rule to a model
+     * \param model
+     * The model
+     * \param rule
+     * The typing rule
+     * \param operands
+     * The typed expression and its operands, indexed by typing::Operand
+     */
+    void addTypingRule(solver::Model::shared_ptr model,
+                       const typing::Rule &rule,
+                       const std::array<belem::Expression::shared_ptr, 3> &operands);
+    /*!
+     * \brief Build the type described by a signature
+     * \param signature
+     * The signature
+     * \param position
+     * The position of the type in the signature, moved after it
+     * \param operands
+     * The typed expression and its operands, indexed by typing::Operand
+     * \param slots
+     * The type variables bound to the slots of the rule
+     * \return the type
+     */
+    solver::AbstractBType::shared_ptr instantiate(const typing::Signature &signature,
+                                                  std::size_t &position,
+                                                  const std::array<belem::Expression::shared_ptr, 3> &operands,
+                                                  const std::array<solver::Variable::shared_ptr, typing::slot_count> &slots);
 };
 
 }
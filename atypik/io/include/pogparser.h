@@ -47,6 +47,10 @@ public:
      * \brief A unique_ptr on a Parser
      */
     typedef std::unique_ptr<Parser> unique_ptr;
+    /*!
+     * \brief A shared_ptr on a Parser
+     */
+    typedef std::shared_ptr<Parser> shared_ptr;
     genericparser::Context::shared_ptr parse(tinyxml2::XMLDocument *pDocument) override;
     /*!
      * \brief Set the type of the bxml from which the pog file was generated, thus allowing
@@ -77,7 +81,9 @@ private:
      */
     void parseDefines(tinyxml2::XMLElement *pPo);
     /*!
-     * \brief Call parseProofObligation on each Proof_Obligation tag
+     * \brief Call parseProofObligation on each Proof_Obligation tag. When
+     * multi threading is enabled, the proof obligations are split into ranges
+     * parsed concurrently by copies of the parser
      * \param pPo
      * A pointer on the Proof_Obligations tag
      */
@@ -0,0 +1,134 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace genericparser
+{
+
+/*!
+ * \brief The SymbolTable class interns the names of the identifiers: each
+ * name is given a dense integer symbol, so that the contexts are indexed by
+ * integers instead of strings. A table can be shared by the parsers parsing
+ * concurrently. Once frozen, the names it already holds are looked up without
+ * locking.
+ */
+class SymbolTable
+{
+public:
+    /*!
+     * \brief A shared_ptr on a SymbolTable
+     */
+    typedef std::shared_ptr<SymbolTable> shared_ptr;
+    /*!
+     * \brief Give the symbol of a name, creating it if the name is new
+     * \param name
+     * The name
+     * \return the symbol of the name
+     */
+    int intern(std::string_view name);
+    /*!
+     * \brief Give the symbol of a prefixed name, creating it if the name is
+     * new. The prefixed name is looked up without being built.
+     * \param prefix
+     * The prefix
+     * \param name
+     * The name following the prefix
+     * \return the symbol of the prefixed name
+     */
+    int intern(std::string_view prefix, std::string_view name);
+    /*!
+     * \brief Freeze the names already interned, which are then looked up
+     * without locking. The new names are still interned, under the lock. It
+     * must not be called concurrently with intern.
+     */
+    void freeze();
+
+private:
+    /*!
+     * \brief A name split in a prefix and the rest of the name
+     */
+    struct Name {
+        std::string_view prefix;
+        std::string_view name;
+    };
+    /*!
+     * \brief A hash of the names accepting split names, which is the hash of
+     * the whole name, so that a name is looked up without being built
+     */
+    struct Hash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const;
+        size_t operator()(const Name &name) const;
+    };
+    /*!
+     * \brief An equality between the names and the split names
+     */
+    struct Equal {
+        using is_transparent = void;
+        bool operator()(std::string_view left, std::string_view right) const;
+        bool operator()(std::string_view left, const Name &right) const;
+        bool operator()(const Name &left, std::string_view right) const;
+    };
+    typedef std::unordered_map<std::string, int, Hash, Equal> Symbols;
+    /*!
+     * \brief Look up a name in a table
+     * \param symbols
+     * The table
+     * \param name
+     * The name
+     * \return the symbol of the name, or -1 if it is not in the table
+     */
+    static int find(const Symbols &symbols, const Name &name);
+    /*!
+     * \brief Whether the table is frozen
+     */
+    bool frozen_ = false;
+    /*!
+     * \brief The mutex protecting the table, the lookups of known names being
+     * shared. Once the table is frozen, it only protects the names added
+     * since.
+     */
+    std::shared_mutex mutex_;
+    /*!
+     * \brief The symbols associated to their name, which are not modified
+     * once the table is frozen
+     */
+    Symbols symbols_;
+    /*!
+     * \brief The symbols of the names added since the table was frozen
+     */
+    Symbols added_;
+};
+}
+
+#endif // SYMBOLTABLE_H
@@ -0,0 +1,404 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#ifndef TYPINGRULES_H
+#define TYPINGRULES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+
+#include "opcodes.h"
+
+namespace genericparser
+{
+
+namespace typing
+{
+
+/*!
+ * \brief The expressions a typing rule refers to: the typed expression and
+ * its operands
+ */
+enum Operand : std::uint8_t { Result, Left, Right, Argument = Left };
+
+/*!
+ * \brief The number of fresh or bound type variables a rule can use
+ */
+inline constexpr std::size_t slot_count = 4;
+
+/*!
+ * \brief The kinds of the symbols of a type signature
+ */
+enum class Node : std::uint8_t { Integer, Real, Float, Pow, Product, Operand, Slot };
+
+/*!
+ * \brief A symbol of a type signature, the index being the operand or the
+ * slot it refers to
+ */
+struct Symbol {
+    Node node;
+    std::uint8_t index;
+};
+
+/*!
+ * \brief A type signature over POW, PRODUCT, the atoms, the types of the
+ * operands and the type variables of the slots, written in prefix notation
+ */
+struct Signature {
+    static constexpr std::size_t capacity = 8;
+    std::array<Symbol, capacity> symbols{};
+    std::uint8_t size = 0;
+};
+
+constexpr Signature atom(Node node, std::uint8_t index = 0) {
+    Signature result;
+    result.symbols[result.size++] = {node, index};
+    return result;
+}
+
+constexpr Signature integer() { return atom(Node::Integer); }
+
+constexpr Signature real() { return atom(Node::Real); }
+
+constexpr Signature floating() { return atom(Node::Float); }
+
+constexpr Signature operand(Operand operand) { return atom(Node::Operand, operand); }
+
+constexpr Signature slot(std::uint8_t slot) { return atom(Node::Slot, slot); }
+
+constexpr Signature compose(Node node, std::initializer_list<Signature> arguments) {
+    Signature result = atom(node);
+    for (const Signature &argument : arguments) {
+        if (result.size + argument.size > Signature::capacity)
+            throw std::length_error("The type signature is too long");
+        for (std::uint8_t i = 0; i < argument.size; i++)
+            result.symbols[result.size++] = argument.symbols[i];
+    }
+    return result;
+}
+
+constexpr Signature pow(Signature type) { return compose(Node::Pow, {type}); }
+
+constexpr Signature product(Signature left, Signature right) {
+    return compose(Node::Product, {left, right});
+}
+
+/*!
+ * \brief The actions of the steps of a typing rule
+ */
+enum class Action : std::uint8_t {
+    // Bind a slot to a fresh type variable
+    Fresh,
+    // Bind a slot to t, the operand being of type POW(t)
+    Set,
+    // Bind a slot to t, the operand being of type POW(INTEGER x t)
+    Sequence,
+    // Bind two slots to t and u, the operand being of type POW(t x u)
+    Relation,
+    // Assert the equality of two signatures
+    Equal
+};
+
+/*!
+ * \brief A step of a typing rule
+ */
+struct Step {
+    Action action;
+    Operand operand = Result;
+    std::array<std::uint8_t, 2> slots{};
+    Signature left{};
+    Signature right{};
+};
+
+constexpr Step fresh(std::uint8_t t) { return {Action::Fresh, Result, {t, 0}}; }
+
+constexpr Step set(Operand operand, std::uint8_t t) {
+    return {Action::Set, operand, {t, 0}};
+}
+
+constexpr Step sequence(Operand operand, std::uint8_t t) {
+    return {Action::Sequence, operand, {t, 0}};
+}
+
+constexpr Step relation(Operand operand, std::uint8_t t, std::uint8_t u) {
+    return {Action::Relation, operand, {t, u}};
+}
+
+constexpr Step equal(Signature left, Signature right) {
+    return {Action::Equal, Result, {}, left, right};
+}
+
+/*!
+ * \brief A typing rule, as the sequence of the steps emitting its
+ * constraints. A rule without steps is undefined
+ */
+struct Rule {
+    static constexpr std::size_t capacity = 5;
+    std::array<Step, capacity> steps{};
+    std::uint8_t size = 0;
+};
+
+constexpr Rule rule(std::initializer_list<Step> steps) {
+    if (steps.size() > Rule::capacity)
+        throw std::length_error("The typing rule has too many steps");
+    Rule result;
+    for (const Step &step : steps)
+        result.steps[result.size++] = step;
+    return result;
+}
+
+/*!
+ * \brief The typing rules indexed by operator
+ */
+typedef std::array<Rule, static_cast<std::size_t>(Operator::Inclusion) + 1> RuleTable;
+
+constexpr void define(RuleTable &table, std::initializer_list<Operator> operators, Rule rule) {
+    for (Operator op : operators)
+        table[static_cast<std::size_t>(op)] = rule;
+}
+
+inline constexpr RuleTable binary_rules = [] {
+    RuleTable table{};
+    define(table, {Operator::CartesianProduct},
+           rule({fresh(0), fresh(1),
+                 equal(operand(Left), pow(slot(0))),
+                 equal(operand(Right), pow(slot(1))),
+                 equal(operand(Result), pow(product(slot(0), slot(1))))}));
+    define(table, {Operator::Concatenation},
+           rule({sequence(Left, 0), sequence(Right, 1),
+                 equal(slot(0), slot(1)),
+                 equal(operand(Result), operand(Left))}));
+    define(table, {Operator::InsertFront},
+           rule({sequence(Right, 0),
+                 equal(operand(Left), slot(0)),
+                 equal(operand(Result), operand(Right))}));
+    define(table, {Operator::InsertTail},
+           rule({sequence(Left, 0),
+                 equal(operand(Right), slot(0)),
+                 equal(operand(Result), operand(Left))}));
+    define(table, {Operator::RestrictFront, Operator::RestrictTail},
+           rule({sequence(Left, 0),
+                 equal(operand(Right), integer()),
+                 equal(operand(Result), operand(Left))}));
+    define(table, {Operator::Interval},
+           rule({equal(operand(Right), integer()),
+                 equal(operand(Left), integer()),
+                 equal(operand(Result), pow(integer()))}));
+    define(table, {Operator::SetDifference, Operator::Intersection, Operator::Union},
+           rule({set(Left, 0), set(Right, 1),
+                 equal(operand(Left), operand(Right)),
+                 equal(operand(Left), operand(Result))}));
+    define(table,
+           {Operator::IntTimes, Operator::IntPower, Operator::IntPlus, Operator::IntMinus,
+            Operator::IntDivide, Operator::Modulo},
+           rule({equal(operand(Left), operand(Right)),
+                 equal(operand(Left), operand(Result)),
+                 equal(operand(Result), integer())}));
+    define(table,
+           {Operator::RealTimes, Operator::RealPower, Operator::RealPlus, Operator::RealMinus,
+            Operator::RealDivide},
+           rule({equal(operand(Left), operand(Right)),
+                 equal(operand(Left), operand(Result)),
+                 equal(operand(Result), real())}));
+    define(table,
+           {Operator::FloatTimes, Operator::FloatPlus, Operator::FloatMinus,
+            Operator::FloatDivide},
+           rule({equal(operand(Left), operand(Right)),
+                 equal(operand(Left), operand(Result)),
+                 equal(operand(Result), floating())}));
+    define(table, {Operator::Maplet, Operator::Comma},
+           rule({equal(operand(Result), product(operand(Left), operand(Right)))}));
+    define(table, {Operator::Relations},
+           rule({set(Left, 0), set(Right, 1),
+                 equal(operand(Result), pow(pow(product(slot(0), slot(1)))))}));
+    define(table, {Operator::FirstProjection},
+           rule({set(Left, 0), set(Right, 1),
+                 equal(operand(Result), pow(product(product(slot(0), slot(1)), slot(0))))}));
+    define(table, {Operator::SecondProjection},
+           rule({set(Left, 0), set(Right, 1),
+                 equal(operand(Result), pow(product(product(slot(0), slot(1)), slot(1))))}));
+    define(table, {Operator::Composition},
+           rule({relation(Left, 0, 1), relation(Right, 2, 3),
+                 equal(slot(1), slot(2)),
+                 equal(operand(Result), pow(product(slot(0), slot(3))))}));
+    define(table, {Operator::DirectProduct},
+           rule({relation(Left, 0, 1), relation(Right, 2, 3),
+                 equal(slot(0), slot(2)),
+                 equal(operand(Result), pow(product(slot(0), product(slot(1), slot(3)))))}));
+    define(table, {Operator::ParallelProduct},
+           rule({relation(Left, 0, 1), relation(Right, 2, 3),
+                 equal(operand(Result),
+                       pow(product(product(slot(0), slot(2)), product(slot(1), slot(3)))))}));
+    define(table, {Operator::Iteration},
+           rule({relation(Left, 0, 1),
+                 equal(slot(0), slot(1)),
+                 equal(operand(Right), integer()),
+                 equal(operand(Result), operand(Left))}));
+    define(table, {Operator::Image},
+           rule({relation(Left, 0, 1), set(Right, 2),
+                 equal(slot(0), slot(2)),
+                 equal(operand(Result), pow(slot(1)))}));
+    define(table, {Operator::DomainSubtraction, Operator::DomainRestriction},
+           rule({set(Left, 0), relation(Right, 1, 2),
+                 equal(slot(0), slot(1)),
+                 equal(operand(Result), operand(Right))}));
+    define(table, {Operator::RangeRestriction, Operator::RangeSubtraction},
+           rule({relation(Left, 0, 1), set(Right, 2),
+                 equal(slot(1), slot(2))}));
+    define(table, {Operator::Overwrite},
+           rule({relation(Left, 0, 1), relation(Right, 2, 3),
+                 equal(slot(0), slot(2)),
+                 equal(slot(1), slot(3)),
+                 equal(operand(Result), operand(Left))}));
+    define(table,
+           {Operator::TotalFunction, Operator::PartialFunction, Operator::PartialInjection,
+            Operator::TotalInjection, Operator::PartialSurjection, Operator::TotalSurjection,
+            Operator::TotalBijection},
+           rule({set(Left, 0), set(Right, 1),
+                 equal(operand(Result), pow(pow(product(slot(0), slot(1)))))}));
+    define(table, {Operator::Evaluation},
+           rule({relation(Left, 0, 1),
+                 equal(slot(0), operand(Right)),
+                 equal(operand(Result), slot(1))}));
+    return table;
+}();
+
+inline constexpr RuleTable unary_rules = [] {
+    RuleTable table{};
+    define(table, {Operator::IntMinus, Operator::Successor, Operator::Predecessor},
+           rule({equal(operand(Argument), integer()),
+                 equal(operand(Result), operand(Argument))}));
+    define(table, {Operator::Real},
+           rule({equal(operand(Argument), integer()),
+                 equal(operand(Result), real())}));
+    define(table, {Operator::Floor, Operator::Ceiling},
+           rule({equal(operand(Argument), real()),
+                 equal(operand(Result), integer())}));
+    define(table, {Operator::IntMax, Operator::IntMin},
+           rule({equal(operand(Argument), pow(integer())),
+                 equal(operand(Result), integer())}));
+    define(table, {Operator::RealMax, Operator::RealMin},
+           rule({equal(operand(Argument), pow(real())),
+                 equal(operand(Result), real())}));
+    define(table, {Operator::Cardinal},
+           rule({set(Argument, 0),
+                 equal(operand(Result), integer())}));
+    define(table,
+           {Operator::Powerset, Operator::Powerset1, Operator::FinitePowerset,
+            Operator::FinitePowerset1},
+           rule({set(Argument, 0),
+                 equal(operand(Result), pow(operand(Argument)))}));
+    define(table,
+           {Operator::Sequences, Operator::Sequences1, Operator::InjectiveSequences,
+            Operator::InjectiveSequences1, Operator::Permutations},
+           rule({fresh(0),
+                 equal(operand(Argument), pow(slot(0))),
+                 equal(operand(Result), pow(pow(product(integer(), slot(0)))))}));
+    define(table, {Operator::Size},
+           rule({sequence(Argument, 0),
+                 equal(operand(Result), integer())}));
+    define(table, {Operator::First, Operator::Last},
+           rule({sequence(Argument, 0),
+                 equal(operand(Result), slot(0))}));
+    define(table, {Operator::Front, Operator::Tail, Operator::Reverse},
+           rule({sequence(Argument, 0),
+                 equal(operand(Result), operand(Argument))}));
+    define(table, {Operator::GeneralizedConcatenation},
+           rule({fresh(0),
+                 equal(operand(Argument),
+                       pow(product(integer(), pow(product(integer(), slot(0)))))),
+                 equal(operand(Result), pow(product(integer(), slot(0))))}));
+    define(table, {Operator::GeneralizedUnion, Operator::GeneralizedIntersection},
+           rule({set(Result, 0),
+                 equal(operand(Argument), pow(operand(Result)))}));
+    define(table, {Operator::Identity},
+           rule({set(Argument, 0),
+                 equal(operand(Result), pow(product(slot(0), slot(0))))}));
+    define(table, {Operator::Inverse},
+           rule({fresh(0), fresh(1),
+                 equal(operand(Argument), pow(product(slot(0), slot(1)))),
+                 equal(operand(Result), pow(product(slot(1), slot(0))))}));
+    define(table, {Operator::Closure, Operator::Closure1},
+           rule({relation(Argument, 0, 1),
+                 equal(slot(0), slot(1)),
+                 equal(operand(Result), operand(Argument))}));
+    define(table, {Operator::Domain},
+           rule({relation(Argument, 0, 1),
+                 equal(operand(Result), pow(slot(0)))}));
+    define(table, {Operator::Range},
+           rule({relation(Argument, 0, 1),
+                 equal(operand(Result), pow(slot(1)))}));
+    define(table, {Operator::Fnc},
+           rule({relation(Argument, 0, 1),
+                 equal(operand(Result), pow(product(slot(0), pow(slot(1)))))}));
+    define(table, {Operator::Rel},
+           rule({relation(Argument, 0, 1), fresh(2),
+                 equal(slot(1), pow(slot(2))),
+                 equal(operand(Result), pow(product(slot(0), slot(2))))}));
+    return table;
+}();
+
+inline constexpr RuleTable comparison_rules = [] {
+    RuleTable table{};
+    define(table, {Operator::Membership, Operator::NonMembership},
+           rule({equal(operand(Right), pow(operand(Left)))}));
+    define(table, {Operator::Equal, Operator::NotEqual},
+           rule({equal(operand(Right), operand(Left))}));
+    define(table,
+           {Operator::IntLessEqual, Operator::IntGreaterEqual, Operator::IntLess,
+            Operator::IntGreater},
+           rule({equal(operand(Right), integer()),
+                 equal(operand(Left), integer())}));
+    define(table,
+           {Operator::RealLessEqual, Operator::RealGreaterEqual, Operator::RealLess,
+            Operator::RealGreater},
+           rule({equal(operand(Right), real()),
+                 equal(operand(Left), real())}));
+    define(table, {Operator::Inclusion},
+           rule({set(Left, 0), set(Right, 1),
+                 equal(operand(Left), operand(Right))}));
+    return table;
+}();
+
+/*!
+ * \brief Fetch a typing rule in a table
+ * \param table
+ * The table of the rules
+ * \param op
+ * The operator
+ * \return the rule of the operator, nullptr if it is not defined in the table
+ */
+constexpr const Rule *findRule(const RuleTable &table, Operator op) {
+    const Rule &rule = table[static_cast<std::size_t>(op)];
+    return rule.size == 0 ? nullptr : &rule;
+}
+
+}
+
+}
+
+#endif // TYPINGRULES_H
@@ -31,6 +31,7 @@
 #include <tinyxml2.h>
 
 #include "expression.h"
+#include "solution.h"
 #include "solverfactory.h"
 #include "set.h"
 
@@ -53,11 +54,11 @@ namespace genericwriter
          * \param expressions
          * The expressions
          * \param var_to_type
-         * A map of shape variable -> type associating a type to each variable
+         * The solution associating a type to each variable
          */
         void write(tinyxml2::XMLDocument *pDocument, std::string output,
                    std::unordered_set<belem::Expression::shared_ptr> expressions,
-                   std::unordered_map<solver::Variable::shared_ptr, std::string> var_to_type);
+                   const solver::Solution &var_to_type);
         /*!
          * \brief Write on stdout the same content as in the given document and add
          * rich typing
@@ -66,11 +67,11 @@ namespace genericwriter
          * \param expressions
          * The expressions
          * \param var_to_type
-         * A map of shape variable -> type associating a type to each variable
+         * The solution associating a type to each variable
          */
         void write(tinyxml2::XMLDocument *pDocument,
                    std::unordered_set<belem::Expression::shared_ptr> expressions,
-                   std::unordered_map<solver::Variable::shared_ptr, std::string> var_to_type);
+                   const solver::Solution &var_to_type);
 
     private:
         // Defining constants for tag
@@ -88,13 +89,47 @@ namespace genericwriter
         const char *arg2_tag_ = "arg2";
 
         /*!
-         * \brief A map associating an id to each type
+         * \brief The kinds of rich types
          */
-        std::unordered_map<std::string, int> types_;
+        enum class Kind
+        {
+            Set,
+            Identifier,
+            PowerSet,
+            Product
+        };
         /*!
-         * \brief A map associating an id to each set
+         * \brief A rich type, its arguments being given by their id
          */
-        std::unordered_map<std::string, int> sets_to_types_;
+        struct RichType
+        {
+            Kind kind;
+            std::string name;
+            int arg1;
+            int arg2;
+            belem::Set::shared_ptr set;
+        };
+        /*!
+         * \brief The rich types indexed by their id
+         */
+        std::vector<RichType> types_;
+        /*!
+         * \brief The ids of the types already visited
+         */
+        std::unordered_map<solver::AbstractBType *, int> type_ids_;
+        /*!
+         * \brief The ids of the identifiers and sets associated to their name
+         */
+        std::unordered_map<std::string, int> identifier_ids_;
+        /*!
+         * \brief The ids of the power sets associated to the id of their argument
+         */
+        std::unordered_map<int, int> power_set_ids_;
+        /*!
+         * \brief The ids of the cartesian products associated to the ids of their
+         * arguments
+         */
+        std::map<std::pair<int, int>, int> product_ids_;
         /*!
          * \brief The document
          */
@@ -112,13 +147,37 @@ namespace genericwriter
          */
         std::unordered_set<std::string> default_identifiers_ = {"INTEGER", "BOOL", "REAL", "FLOAT", "STRING", "A"};
         /*!
-         * \brief A map of shape variable -> type associating a type to each variable
+         * \brief The solution associating a type to each variable
          */
-        std::unordered_map<solver::Variable::shared_ptr, std::string> var_to_type_;
+        solver::Solution var_to_type_;
         /*!
-         * \brief Fill the types_ attribute
+         * \brief Fill the types_ attribute with the sets, their power sets and
+         * the types of the variables
          */
         void computeTypes();
+        /*!
+         * \brief Compute the id of a type, adding it and its arguments to the
+         * types_ attribute if they are not already in it
+         * \param type
+         * The type
+         * \return the id of the type
+         */
+        int getTypeId(solver::AbstractBType::shared_ptr type);
+        /*!
+         * \brief Give an existing id to the types structurally equal to a type
+         * \param type
+         * The type
+         * \param id
+         * The id
+         */
+        void setTypeId(solver::AbstractBType::shared_ptr type, int id);
+        /*!
+         * \brief Add a rich type to the types_ attribute
+         * \param type
+         * The rich type
+         * \return the id of the rich type
+         */
+        int addRichType(RichType type);
         /*!
          * \brief Add the rich type to each expression in the given map
          */
@@ -127,18 +186,14 @@ namespace genericwriter
          * \brief Add the Rich_Type tag
          */
         void addRichTypesInfo();
-        /**
-         * @brief Add POW and PRODUCT arguments if they are not already in the types_ map
-         */
-        void addArgsTypes();
         /*!
          * \brief Add the given type to a Type tag
          * \param pType
          * A pointer on the Type tag
-         * \param type
-         * The type to add
+         * \param id
+         * The id of the type to add
          */
-        void addType(tinyxml2::XMLElement *pType, std::string type);
+        void addType(tinyxml2::XMLElement *pType, int id);
         /*!
          * \brief Add the given set type to a Type tag
          * \param pType
@@ -147,28 +202,6 @@ namespace genericwriter
          * The set to add
          */
         void addSetType(tinyxml2::XMLElement *pType, belem::Set::shared_ptr set);
-        /**
-         * @brief Add the given power set type to a type tag
-         * @param pType
-         * A pointer on the type tag
-         * @param set
-         * The set to add
-         */
-        void addPowerSetType(tinyxml2::XMLElement *pType, belem::Set::shared_ptr set);
-        /*!
-         * \brief Compute the argument of a string representing a POW expression
-         * \param pow
-         * The POW expression
-         * \return the argument of the POW expression
-         */
-        std::string getArgFromPow(const std::string &pow);
-        /*!
-         * \brief Compute the arguments A and B from q string representing a A x B
-         * \param product
-         * The product A x B
-         * \return A and B
-         */
-        std::pair<std::string, std::string> getArgsFromCartesianProduct(const std::string &product);
     };
 }
 
@@ -24,14 +24,16 @@
  */
 #include "bxmlposition.h"
 
+#include <type_traits>
+
 using namespace bxml;
 using namespace tinyxml2;
 using std::string;
 
+static_assert(std::is_trivially_destructible_v<Position>);
+
 Position::Position(int line, int column, int span, XMLElement *pElement)
-    : line_(line), column_(column), span_(span), pElement_(pElement) {
-  if (pElement->Attribute("tag")) tag_ = pElement->Attribute("tag");
-}
+    : line_(line), column_(column), span_(span), pElement_(pElement) {}
 
 int Position::getLine() { return line_; }
 
@@ -39,6 +41,9 @@ int Position::getColumn() { return column_; }
 
 int Position::getSpan() { return span_; }
 
-string Position::getTag() { return tag_; };
+string Position::getTag() {
+  const char *tag = pElement_->Attribute("tag");
+  return tag != nullptr ? tag : "";
+}
 
 XMLElement *Position::getTinyXMLElement() { return pElement_; }
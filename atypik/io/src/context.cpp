@@ -67,16 +67,19 @@ Context::Context(bool add_set) {
   }
 }
 
-void Context::push(belem::Expression::shared_ptr identifier) {
-  string id = identifier->format();
-  identifiers_[id].emplace_back(identifier);
+void Context::push(int symbol, belem::Expression::shared_ptr identifier) {
+  identifiers_[symbol] = identifier;
 }
 
-belem::Expression::shared_ptr Context::get(string identifier) {
-  if (identifiers_.contains(identifier)) {
-    return identifiers_[identifier].back();
+belem::Expression::shared_ptr Context::find(int symbol) const {
+  auto found = identifiers_.find(symbol);
+  if (found != identifiers_.end()) return found->second;
+  // The last scopes hide the previous ones
+  for (auto scope = scopes_.rbegin(); scope != scopes_.rend(); scope++) {
+    auto in_scope = (*scope)->find(symbol);
+    if (in_scope != (*scope)->end()) return in_scope->second;
   }
-  throw IdentifierOutOfScope(identifier);
+  return nullptr;
 }
 
 bool Context::containsSet(string name) { return sets_.contains(name); }
@@ -97,6 +100,8 @@ void Context::setOperations(
 
 void Context::SetModels(vector<Model::shared_ptr> models) { models_ = models; }
 
+void Context::setBaseModel(Model::shared_ptr model) { base_model_ = model; }
+
 const unordered_set<Expression::shared_ptr>& Context::getExpressions() const {
   return expressions_;
 }
@@ -109,35 +114,53 @@ unordered_set<Operation::shared_ptr> Context::getOperations() {
 
 vector<Model::shared_ptr> Context::getModels() { return models_; }
 
+Model::shared_ptr Context::getBaseModel() { return base_model_; }
+
 Context::shared_ptr Context::copy_shared_ptr() {
+  freeze();
   Context::shared_ptr result = make_shared<Context>();
-  result->identifiers_ = identifiers_;
+  result->scopes_ = scopes_;
   result->sets_ = sets_;
-  result->expressions_ = expressions_;
-  result->operations_ = operations_;
   return result;
 }
 
 Context::shared_ptr Context::merge(Context::shared_ptr context) {
-  Context::shared_ptr result = copy_shared_ptr();
-  result->identifiers_.insert(context->identifiers_.begin(),
-                              context->identifiers_.end());
+  freeze();
+  context->freeze();
+  Context::shared_ptr result = make_shared<Context>();
+  // The scopes of the current context come last to hide the other ones
+  result->scopes_ = context->scopes_;
+  result->scopes_.insert(result->scopes_.end(), scopes_.begin(),
+                         scopes_.end());
+  result->sets_ = sets_;
   result->sets_.insert(context->sets_.begin(), context->sets_.end());
-  unordered_map<string, Expression::shared_ptr> name_to_exp;
-  unordered_set<Expression::shared_ptr> new_expressions;
-  for (auto& expression : result->expressions_)
-    name_to_exp[expression->format()] = expression;
-  for (auto& expression : context->expressions_)
-    name_to_exp[expression->format()] = expression;
-  for (auto& [_, expression] : name_to_exp) new_expressions.insert(expression);
-  result->expressions_ = move(new_expressions);
-  result->operations_.insert(context->operations_.begin(),
-                             context->operations_.end());
   return result;
 }
 
 void Context::removeIdentifiers(Context::shared_ptr context) {
-  for (auto& [name, _] : context->identifiers_) identifiers_.erase(name);
+  // The visible identifiers are gathered into a single scope, without the
+  // names known by the given context
+  Scope identifiers;
+  for (auto& scope : scopes_) {
+    for (auto& [symbol, identifier] : *scope) identifiers[symbol] = identifier;
+  }
+  for (auto& [symbol, identifier] : identifiers_)
+    identifiers[symbol] = identifier;
+  context->freeze();
+  for (auto& scope : context->scopes_) {
+    for (auto& [symbol, _] : *scope) identifiers.erase(symbol);
+  }
+  identifiers_ = move(identifiers);
+  scopes_.clear();
+  // The context may then be shared by concurrent merges, which must not
+  // modify it
+  freeze();
+}
+
+void Context::freeze() {
+  if (identifiers_.empty()) return;
+  scopes_.push_back(make_shared<const Scope>(move(identifiers_)));
+  identifiers_ = {};
 }
 
 }  // namespace genericparser
@@ -26,6 +26,9 @@
 
 #include <algorithm>
 
+#include "arena.h"
+#include "opcodes.h"
+
 using namespace bxml;
 using namespace tinyxml2;
 using belem::Any;
@@ -74,8 +77,11 @@ using solver::BIdent;
 using solver::BPow;
 using solver::Equals;
 using solver::Model;
+using solver::Provenance;
 using solver::VarGenerator;
 using solver::Variable;
+using std::allocate_shared;
+using std::array;
 using std::dynamic_pointer_cast;
 using std::make_shared;
 using std::pair;
@@ -87,6 +93,48 @@ using std::string;
 
 namespace genericparser {
 
+namespace {
+/*
+ * Gives the provenance of an element to the assertions created while it is
+ * parsed. The provenance of the enclosing element is restored afterwards.
+ */
+class ProvenanceScope {
+ public:
+  ProvenanceScope(solver::Factory &factory, Tag tag, XMLElement *pElement,
+                  int line, int column)
+      : factory_(factory), previous_(factory.getProvenance()) {
+    // Only the static names of the tag and of the operator are kept, the
+    // description is built if an error is displayed
+    const char *op = pElement->Attribute("op");
+    factory_.setProvenance(
+        Provenance(getName(tag), op ? getName(computeOperator(op)) : "", line,
+                   column));
+  }
+  ~ProvenanceScope() { factory_.setProvenance(previous_); }
+
+ private:
+  solver::Factory &factory_;
+  Provenance previous_;
+};
+
+/*
+ * Reads the line, column and span of the position of an element, -1 when the
+ * element has no position
+ */
+array<int, 3> readPosition(XMLElement *pAttr) {
+  array<int, 3> result = {-1, -1, -1};
+  if (pAttr != nullptr) {
+    XMLElement *pPos = pAttr->FirstChildElement("Pos");
+    if (pPos != nullptr) {
+      result[0] = pPos->Int64Attribute("l");
+      result[1] = pPos->Int64Attribute("c");
+      result[2] = pPos->Int64Attribute("s");
+    }
+  }
+  return result;
+}
+}  // namespace
+
 // Implementation of the errors
 
 UnknownXmlElement::UnknownXmlElement(string msg) : message_(msg) {}
@@ -101,8 +149,15 @@ const char *ParserError::what() const noexcept { return message_.c_str(); }
 
 void Parser::disableMultiThread() { enable_multi_thread_ = false; }
 
+void Parser::enableIncrementalSolving() { enable_incremental_solving_ = true; }
+
+void Parser::enableDefinesSeeding() { enable_defines_seeding_ = true; }
+
 void Parser::addExpression(Model::shared_ptr model,
                            Expression::shared_ptr expression) {
+  if (shared_expressions_ != nullptr and
+      shared_expressions_->contains(expression))
+    return;
   if (not expressions_.contains(expression)) {
     model->add(expression->getAssociatedVariable());
     expressions_.insert(expression);
@@ -112,115 +167,144 @@ void Parser::addExpression(Model::shared_ptr model,
 // Implementation of the parser
 
 Model::shared_ptr Parser::initModel() {
-  solver::Factory factory = solver::Factory();
-  Model::shared_ptr result = factory.makeModel();
+  Model::shared_ptr result = s_factory_.makeModel();
   // Generic type
-  result->add(factory.makeBIdent("A"));
-  result->add(factory.makeBIdent("FLOAT"));
-  result->add(factory.makeInteger());
-  result->add(factory.makeBool());
-  result->add(factory.makeReal());
-  result->add(factory.makeString());
+  result->add(s_factory_.makeBIdent("A"));
+  result->add(s_factory_.makeBIdent("FLOAT"));
+  result->add(s_factory_.makeInteger());
+  result->add(s_factory_.makeBool());
+  result->add(s_factory_.makeReal());
+  result->add(s_factory_.makeString());
   return result;
 }
 
 Position::shared_ptr Parser::getPosition(XMLElement *pAttr,
                                          XMLElement *pElement) {
-  int l = -1, c = -1, s = -1;
-  if (pAttr != nullptr) {
-    XMLElement *pPos = pAttr->FirstChildElement("Pos");
-    if (pPos != nullptr) {
-      l = pPos->Int64Attribute("l");
-      c = pPos->Int64Attribute("c");
-      s = pPos->Int64Attribute("s");
-    }
-  }
-  return make_shared<Position>(l, c, s, pElement);
+  array<int, 3> position = readPosition(pAttr);
+  // The positions are trivially destructible, and allocated in the arena of
+  // the session like the elements
+  return allocate_shared<Position>(b_factory_.getAllocator(), position[0],
+                                   position[1], position[2], pElement);
 }
 
 Expression::shared_ptr Parser::parseExpression(XMLElement *pExpression,
                                                Context::shared_ptr context,
                                                Model::shared_ptr model,
                                                bool lookup_in_context) {
-  string tag = pExpression->Value();
-  string tag_id;
-  if (pExpression->Attribute("tag")) tag_id = pExpression->Attribute("tag");
+  const char *tag = pExpression->Value();
+  Tag code = computeTag(tag);
   Position::shared_ptr pos =
       getPosition(pExpression->FirstChildElement("Attr"), pExpression);
-
-  if (tag == "Id")
-    return parseId(pExpression, context, model, pos, lookup_in_context);
-  if (tag == "Boolean_Literal")
-    return parseDefaultType(pExpression, context, model, "BOOL", pos);
-  if (tag == "Integer_Literal")
-    return parseDefaultType(pExpression, context, model, "INTEGER", pos);
-  if (tag == "Real_Literal")
-    return parseDefaultType(pExpression, context, model, "REAL", pos);
-  if (tag == "String_Literal")
-    return parseDefaultType(pExpression, context, model, "STRING", pos);
-  if (tag == "Binary_Exp")
-    return parseBinaryExpression(pExpression, context, model, pos);
-  if (tag == "Unary_Exp")
-    return parseUnaryExpression(pExpression, context, model, pos);
-  if (tag == "Boolean_Exp")
-    return parseBooleanExpression(pExpression, context, model, pos);
-  if (tag == "Nary_Exp")
-    return parseNaryExpression(pExpression, context, model, pos);
-  if (tag == "Set")
-    return parseSet(pExpression, context, model, pos, Abstraction);
-  if (tag == "EmptySeq") return parseEmptySeq(context, model, pos);
-  if (tag == "EmptySet") return parseEmptySet(context, model, pos);
-  if (tag == "Quantified_Set")
-    return parseQuantifiedSet(pExpression, context, model, pos);
-  if (tag == "Quantified_Exp")
-    return parseQuantifiedExp(pExpression, context, model, pos);
-  if (tag == "Valuation")
-    return parseValuation(pExpression, context, model, pos);
-
-  throw UnknownXmlElement(tag + " is an unknown tag for an expression");
+  ProvenanceScope provenance(s_factory_, code, pExpression, pos->getLine(),
+                             pos->getColumn());
+
+  switch (code) {
+    case Tag::Id:
+      return parseId(pExpression, context, model, pos, lookup_in_context);
+    case Tag::BooleanLiteral:
+      return parseDefaultType(pExpression, context, model, "BOOL", pos);
+    case Tag::IntegerLiteral:
+      return parseDefaultType(pExpression, context, model, "INTEGER", pos);
+    case Tag::RealLiteral:
+      return parseDefaultType(pExpression, context, model, "REAL", pos);
+    case Tag::StringLiteral:
+      return parseDefaultType(pExpression, context, model, "STRING", pos);
+    case Tag::BinaryExp:
+      return parseBinaryExpression(pExpression, context, model, pos);
+    case Tag::UnaryExp:
+      return parseUnaryExpression(pExpression, context, model, pos);
+    case Tag::BooleanExp:
+      return parseBooleanExpression(pExpression, context, model, pos);
+    case Tag::NaryExp:
+      return parseNaryExpression(pExpression, context, model, pos);
+    case Tag::Set:
+      return parseSet(pExpression, context, model, pos, Abstraction);
+    case Tag::EmptySeq:
+      return parseEmptySeq(context, model, pos);
+    case Tag::EmptySet:
+      return parseEmptySet(context, model, pos);
+    case Tag::QuantifiedSet:
+      return parseQuantifiedSet(pExpression, context, model, pos);
+    case Tag::QuantifiedExp:
+      return parseQuantifiedExp(pExpression, context, model, pos);
+    case Tag::Valuation:
+      return parseValuation(pExpression, context, model, pos);
+    default:
+      throw UnknownXmlElement(string(tag) +
+                              " is an unknown tag for an expression");
+  }
 }
 
 Instruction::shared_ptr Parser::parseInstruction(XMLElement *pInstruction,
                                                  Context::shared_ptr context,
                                                  Model::shared_ptr model) {
-  string tag = pInstruction->Value();
+  const char *tag = pInstruction->Value();
+  Tag code = computeTag(tag);
   Position::shared_ptr pos =
       getPosition(pInstruction->FirstChildElement("Attr"), pInstruction);
-  if (tag == "Nary_Sub") return parseNarySub(pInstruction, context, model);
-  if (tag == "Assignement_Sub")
-    return parseAssignments(pInstruction, context, model);
-  if (tag == "Bloc_Sub") return parseBlock(pInstruction, context, model);
-  if (tag == "Skip") return belem::Factory::makeSkip();
-  if (tag == "Assert_Sub") return parseAssertion(pInstruction, context, model);
-  if (tag == "If_Sub") return parseIf(pInstruction, context, model);
-  if (tag == "Select") return parseSelect(pInstruction, context, model);
-  if (tag == "Case_Sub") return parseCase(pInstruction, context, model);
-  if (tag == "ANY_Sub") return parseAny(pInstruction, context, model);
-  if (tag == "LET_Sub") return parseLet(pInstruction, context, model);
-  if (tag == "Becomes_In") return parseBecomesIn(pInstruction, context, model);
-  if (tag == "Becomes_Such_That")
-    return parseBecomesSuchThat(pInstruction, context, model);
-  if (tag == "VAR_IN") return parseVarIn(pInstruction, context, model);
-  if (tag == "Operation_Call")
-    return parseOperationCall(pInstruction, context, model);
-  if (tag == "While") return parseLoop(pInstruction, context, model);
-
-  throw UnknownXmlElement(tag + " is an unknown tag for an instruction");
+  ProvenanceScope provenance(s_factory_, code, pInstruction, pos->getLine(),
+                             pos->getColumn());
+  switch (code) {
+    case Tag::NarySub:
+      return parseNarySub(pInstruction, context, model);
+    case Tag::AssignementSub:
+      return parseAssignments(pInstruction, context, model);
+    case Tag::BlocSub:
+      return parseBlock(pInstruction, context, model);
+    case Tag::Skip:
+      return b_factory_.makeSkip();
+    case Tag::AssertSub:
+      return parseAssertion(pInstruction, context, model);
+    case Tag::IfSub:
+      return parseIf(pInstruction, context, model);
+    case Tag::Select:
+      return parseSelect(pInstruction, context, model);
+    case Tag::CaseSub:
+      return parseCase(pInstruction, context, model);
+    case Tag::AnySub:
+      return parseAny(pInstruction, context, model);
+    case Tag::LetSub:
+      return parseLet(pInstruction, context, model);
+    case Tag::BecomesIn:
+      return parseBecomesIn(pInstruction, context, model);
+    case Tag::BecomesSuchThat:
+      return parseBecomesSuchThat(pInstruction, context, model);
+    case Tag::VarIn:
+      return parseVarIn(pInstruction, context, model);
+    case Tag::OperationCall:
+      return parseOperationCall(pInstruction, context, model);
+    case Tag::While:
+      return parseLoop(pInstruction, context, model);
+    default:
+      throw UnknownXmlElement(string(tag) +
+                              " is an unknown tag for an instruction");
+  }
 }
 
 Predicate::shared_ptr Parser::parsePredicate(XMLElement *pPredicate,
                                              Context::shared_ptr context,
                                              Model::shared_ptr model) {
-  string tag = pPredicate->Value();
-  if (tag == "Unary_Pred") return parseUnaryPred(pPredicate, context, model);
-  if (tag == "Nary_Pred") return parseNaryPred(pPredicate, context, model);
-  if (tag == "Exp_Comparison")
-    return parseComparison(pPredicate, context, model);
-  if (tag == "Quantified_Pred")
-    return parseQuantifiedPred(pPredicate, context, model);
-  if (tag == "Binary_Pred") return parseBinaryPred(pPredicate, context, model);
-
-  throw UnknownXmlElement(tag + " is an unknown tag for a predicate");
+  const char *tag = pPredicate->Value();
+  Tag code = computeTag(tag);
+  // The predicates have no Position, only the line and column are read
+  array<int, 3> position = readPosition(pPredicate->FirstChildElement("Attr"));
+  ProvenanceScope provenance(s_factory_, code, pPredicate, position[0],
+                             position[1]);
+  switch (code) {
+    case Tag::UnaryPred:
+      return parseUnaryPred(pPredicate, context, model);
+    case Tag::NaryPred:
+      return parseNaryPred(pPredicate, context, model);
+    case Tag::ExpComparison:
+      return parseComparison(pPredicate, context, model);
+    case Tag::QuantifiedPred:
+      return parseQuantifiedPred(pPredicate, context, model);
+    case Tag::BinaryPred:
+      return parseBinaryPred(pPredicate, context, model);
+    default:
+      throw UnknownXmlElement(string(tag) +
+                              " is an unknown tag for a predicate");
+  }
 }
 
 void Parser::parseIdentifiers(tinyxml2::XMLElement *pIdentifiers,
@@ -254,12 +338,12 @@ void Parser::parseParameters(XMLElement *pParameters,
       string name = pParam->Attribute("value");
       Position::shared_ptr pos =
           getPosition(pParam->FirstChildElement("Attr"), pParam);
-      Ident::shared_ptr id = belem::Factory::makeIdent(name, pos);
+      Ident::shared_ptr id = b_factory_.makeIdent(name, pos);
       // If name is upper, it is a set
       if (std::all_of(name.begin(), name.end(), [](unsigned char c) {
             return std::isupper(c) or c == '_';
           })) {
-        Set::shared_ptr set = belem::Factory::makeSet(id, {}, pos);
+        Set::shared_ptr set = b_factory_.makeSet(id, {}, pos);
         if (type == Implementation)
           // The type of a set SET is POW(INTEGER) in an implementation
           model->add(s_factory_.makeAssertEquals(
@@ -268,7 +352,10 @@ void Parser::parseParameters(XMLElement *pParameters,
         else {
           // Adding the new set type to the model
           model->add(s_factory_.makeBIdent(id->format()));
-          global_context_->pushSet(id->format());
+          {
+            std::lock_guard<std::mutex> lock(*global_context_mutex_);
+            global_context_->pushSet(id->format());
+          }
 
           // The type of a set SET is POW(SET) in an abstraction
           model->add(s_factory_.makeAssertEquals(
@@ -339,21 +426,24 @@ Ident::shared_ptr Parser::parseId(XMLElement *pId, Context::shared_ptr context,
   string name = pId->Attribute("value");
   const char *suffix = pId->Attribute("suffix");
   if (suffix != nullptr) name += suffix;
+  int symbol = symbols_->intern(prefix_, name);
   Ident::shared_ptr identifier;
-  try {
-    if (not lookup_in_context) throw IdentifierOutOfScope("");
-    identifier = context->get(prefix_ + name);
+  if (lookup_in_context) identifier = context->find(symbol);
+  if (identifier != nullptr) {
     identifier->addPosition(pos);
-  } catch (IdentifierOutOfScope) {
+  } else {
     // If the identifier is a set
+    std::unique_lock<std::mutex> lock(*global_context_mutex_);
     if (global_context_->containsSet(name)) {
-      try {
-        identifier = global_context_->get(name);
+      int set_symbol = symbols_->intern(name);
+      identifier = global_context_->find(set_symbol);
+      if (identifier != nullptr) {
         identifier->addPosition(pos);
-      } catch (IdentifierOutOfScope) {
-        identifier = belem::Factory::makeIdent(name, pos);
-        global_context_->push(identifier);
+      } else {
+        identifier = b_factory_.makeIdent(name, pos);
+        global_context_->push(set_symbol, identifier);
       }
+      lock.unlock();
       // INT and NAT are a subsets of INTEGER
       if (name == "INT" or name == "NATURAL" or name == "NATURAL1" or
           name == "NAT" or name == "NAT1")
@@ -365,8 +455,9 @@ Ident::shared_ptr Parser::parseId(XMLElement *pId, Context::shared_ptr context,
             identifier->getAssociatedVariable(),
             s_factory_.makeBPow(s_factory_.makeBIdent(name))));
     } else {
-      identifier = belem::Factory::makeIdent(prefix_ + name, pos);
-      context->push(identifier);
+      lock.unlock();
+      identifier = b_factory_.makeIdent(prefix_ + name, pos);
+      context->push(symbol, identifier);
     }
     addExpression(model, identifier);
   }
@@ -380,10 +471,10 @@ Expression::shared_ptr Parser::parseDefaultType(XMLElement *pTag,
                                                 Position::shared_ptr pos) {
   const char *value = pTag->Attribute("value");
   Expression::shared_ptr result;
-  if (type_name == "BOOL") result = belem::Factory::makeBool(value, pos);
-  if (type_name == "INTEGER") result = belem::Factory::makeInt(value, pos);
-  if (type_name == "REAL") result = belem::Factory::makeReal(value, pos);
-  if (type_name == "STRING") result = belem::Factory::makeString(value, pos);
+  if (type_name == "BOOL") result = b_factory_.makeBool(value, pos);
+  if (type_name == "INTEGER") result = b_factory_.makeInt(value, pos);
+  if (type_name == "REAL") result = b_factory_.makeReal(value, pos);
+  if (type_name == "STRING") result = b_factory_.makeString(value, pos);
 
   addExpression(model, result);
   model->add(s_factory_.makeAssertEquals(result->getAssociatedVariable(),
@@ -400,7 +491,7 @@ Set::shared_ptr Parser::parseSet(XMLElement *pSet, Context::shared_ptr context,
       static_pointer_cast<Ident>(parseExpression(pId, context, model));
   vector<Expression::shared_ptr> values =
       parseExpressions(pValues, context, model);
-  Set::shared_ptr set = belem::Factory::makeSet(id, values, pos);
+  Set::shared_ptr set = b_factory_.makeSet(id, values, pos);
 
   // In the case of an implementation, non enumerated sets should be valuated as
   // INTEGER sets
@@ -412,7 +503,10 @@ Set::shared_ptr Parser::parseSet(XMLElement *pSet, Context::shared_ptr context,
   } else {
     // Adding the new set type to the model
     model->add(s_factory_.makeBIdent(id->format()));
-    global_context_->pushSet(id->format());
+    {
+      std::lock_guard<std::mutex> lock(*global_context_mutex_);
+      global_context_->pushSet(id->format());
+    }
 
     // The type of a set SET is POW(SET) in an abstraction
     model->add(s_factory_.makeAssertEquals(
@@ -449,7 +543,7 @@ NarySub::shared_ptr Parser::parseNarySub(XMLElement *pSub,
   for (XMLElement *pContent = pStart; pContent != nullptr;
        pContent = pContent->NextSiblingElement())
     instructions.emplace_back(parseInstruction(pContent, context, model));
-  return belem::Factory::makeNarySub(instructions, op);
+  return b_factory_.makeNarySub(instructions, op);
 }
 
 Assignments::shared_ptr Parser::parseAssignments(XMLElement *pAssignments,
@@ -465,7 +559,7 @@ Assignments::shared_ptr Parser::parseAssignments(XMLElement *pAssignments,
     model->add(s_factory_.makeAssertEquals(vars[i]->getAssociatedVariable(),
                                            vals[i]->getAssociatedVariable()));
   }
-  return belem::Factory::makeAssignments(vars, vals);
+  return b_factory_.makeAssignments(vars, vals);
 }
 
 Block::shared_ptr Parser::parseBlock(XMLElement *pBlock,
@@ -478,7 +572,7 @@ Block::shared_ptr Parser::parseBlock(XMLElement *pBlock,
   else
     pBody = pPos->NextSiblingElement();
   Instruction::shared_ptr body = parseInstruction(pBody, context, model);
-  return belem::Factory::makeBlock(body);
+  return b_factory_.makeBlock(body);
 }
 
 UnaryPred::shared_ptr Parser::parseUnaryPred(XMLElement *pPred,
@@ -489,7 +583,7 @@ UnaryPred::shared_ptr Parser::parseUnaryPred(XMLElement *pPred,
   XMLElement *pArg = pPred->FirstChildElement();
   if (pPos != nullptr) pArg = pArg->NextSiblingElement();
   Predicate::shared_ptr arg = parsePredicate(pArg, context, model);
-  return belem::Factory::makeUnaryPred(op, arg);
+  return b_factory_.makeUnaryPred(op, arg);
 }
 
 NaryPred::shared_ptr Parser::parseNaryPred(XMLElement *pPred,
@@ -500,7 +594,7 @@ NaryPred::shared_ptr Parser::parseNaryPred(XMLElement *pPred,
   for (XMLElement *pClause = pPred->FirstChildElement(); pClause != nullptr;
        pClause = pClause->NextSiblingElement())
     clauses.emplace_back(parsePredicate(pClause, context, model));
-  return belem::Factory::makeNaryPred(clauses, op);
+  return b_factory_.makeNaryPred(clauses, op);
 }
 
 Comparison::shared_ptr Parser::parseComparison(XMLElement *pPred,
@@ -516,37 +610,12 @@ Comparison::shared_ptr Parser::parseComparison(XMLElement *pPred,
   string op = pPred->Attribute("op");
   Expression::shared_ptr left = parseExpression(pLeft, context, model);
   Expression::shared_ptr right = parseExpression(pRight, context, model);
-  if (op == ":" or op == "/:")
-    // for expr1 : expr2 of types T1 and T2, T2 = POW(T1)
-    model->add(s_factory_.makeAssertEquals(
-        right->getAssociatedVariable(),
-        s_factory_.makeBPow(left->getAssociatedVariable())));
-  else if (op == "=" or op == "/=")
-    // Both operands must have the same type
-    model->add(s_factory_.makeAssertEquals(right->getAssociatedVariable(),
-                                           left->getAssociatedVariable()));
-  else if (op == "<=i" or op == ">=i" or op == "<i" or op == ">i") {
-    // Both operand type is integer
-    model->add(s_factory_.makeAssertEquals(right->getAssociatedVariable(),
-                                           s_factory_.makeInteger()));
-    model->add(s_factory_.makeAssertEquals(left->getAssociatedVariable(),
-                                           s_factory_.makeInteger()));
-  } else if (op == "<=r" or op == ">=r" or op == "<r" or op == ">r") {
-    // Both operand type is real
-    model->add(s_factory_.makeAssertEquals(right->getAssociatedVariable(),
-                                           s_factory_.makeReal()));
-    model->add(s_factory_.makeAssertEquals(left->getAssociatedVariable(),
-                                           s_factory_.makeReal()));
-  } else if (op == "<:") {
-    // Both operands must be sets
-    Variable::shared_ptr t1 = addSetTypeConstraint(model, left);
-    Variable::shared_ptr t2 = addSetTypeConstraint(model, right);
-    // Left and right operands must have the same type
-    model->add(s_factory_.makeAssertEquals(left->getAssociatedVariable(),
-                                           right->getAssociatedVariable()));
-  } else
+  const typing::Rule *rule =
+      typing::findRule(typing::comparison_rules, computeOperator(op));
+  if (rule == nullptr)
     throw UnknownXmlElement("<Exp_Comparison op=\"" + op + "\">");
-  return belem::Factory::makeComparison(left, op, right);
+  addTypingRule(model, *rule, {nullptr, left, right});
+  return b_factory_.makeComparison(left, op, right);
 }
 
 Assert::shared_ptr Parser::parseAssertion(XMLElement *pAssertion,
@@ -558,7 +627,7 @@ Assert::shared_ptr Parser::parseAssertion(XMLElement *pAssertion,
       parsePredicate(pGuard->FirstChildElement(), context, model);
   Instruction::shared_ptr body =
       parseInstruction(pBody->FirstChildElement(), context, model);
-  return belem::Factory::makeAssert(condition, body);
+  return b_factory_.makeAssert(condition, body);
 }
 
 Conditional::shared_ptr Parser::parseIf(XMLElement *pIf,
@@ -573,7 +642,7 @@ Conditional::shared_ptr Parser::parseIf(XMLElement *pIf,
   consequent = parseInstruction(pThen->FirstChildElement(), context, model);
   if (pElse != nullptr)
     alternative = parseInstruction(pElse->FirstChildElement(), context, model);
-  return belem::Factory::makeIf(condition, consequent, alternative);
+  return b_factory_.makeIf(condition, consequent, alternative);
 }
 
 Select::shared_ptr Parser::parseSelect(XMLElement *pSelect,
@@ -594,7 +663,7 @@ Select::shared_ptr Parser::parseSelect(XMLElement *pSelect,
   }
   if (pElse != nullptr)
     alternative = parseInstruction(pElse->FirstChildElement(), context, model);
-  return belem::Factory::makeSelect(conditions, consequences, alternative);
+  return b_factory_.makeSelect(conditions, consequences, alternative);
 }
 
 Case::shared_ptr Parser::parseCase(XMLElement *pCase,
@@ -620,7 +689,7 @@ Case::shared_ptr Parser::parseCase(XMLElement *pCase,
   if (pElse != nullptr)
     alternative = parseInstruction(pElse->FirstChildElement(), context, model);
   Case::shared_ptr bcase =
-      belem::Factory::makeCase(value, choices, consequences, alternative);
+      b_factory_.makeCase(value, choices, consequences, alternative);
   // value should not be of type POW(t)
   Variable::shared_ptr t = VarGenerator::getNewVariable();
   model->add(t);
@@ -660,7 +729,7 @@ Any::shared_ptr Parser::parseAny(XMLElement *pAny, Context::shared_ptr context,
       parsePredicate(pPred->FirstChildElement(), local_context, model);
   Instruction::shared_ptr body =
       parseInstruction(pThen->FirstChildElement(), local_context, model);
-  return belem::Factory::makeAny(variables, predicate, body);
+  return b_factory_.makeAny(variables, predicate, body);
 }
 
 Let::shared_ptr Parser::parseLet(XMLElement *pLet, Context::shared_ptr context,
@@ -681,7 +750,7 @@ Let::shared_ptr Parser::parseLet(XMLElement *pLet, Context::shared_ptr context,
 
   Instruction::shared_ptr body =
       parseInstruction(pThen->FirstChildElement(), local_context, model);
-  return belem::Factory::makeLet(variables, values, body);
+  return b_factory_.makeLet(variables, values, body);
 }
 
 BecomesIn::shared_ptr Parser::parseBecomesIn(XMLElement *pBecomes,
@@ -708,7 +777,7 @@ BecomesIn::shared_ptr Parser::parseBecomesIn(XMLElement *pBecomes,
   // The type of the set should be POW(t) assuming the vector is of type t
   model->add(s_factory_.makeAssertEquals(set->getAssociatedVariable(),
                                          s_factory_.makeBPow(t)));
-  return belem::Factory::makeBecomesIn(variables, set);
+  return b_factory_.makeBecomesIn(variables, set);
 }
 
 BecomesSuchThat::shared_ptr Parser::parseBecomesSuchThat(
@@ -722,7 +791,7 @@ BecomesSuchThat::shared_ptr Parser::parseBecomesSuchThat(
     variables.emplace_back(parseExpression(pVariable, context, model));
   Predicate::shared_ptr pred =
       parsePredicate(pPred->FirstChildElement(), context, model);
-  return belem::Factory::makeBecomesSuchThat(variables, pred);
+  return b_factory_.makeBecomesSuchThat(variables, pred);
 }
 
 VarIn::shared_ptr Parser::parseVarIn(XMLElement *pVarIn,
@@ -738,7 +807,7 @@ VarIn::shared_ptr Parser::parseVarIn(XMLElement *pVarIn,
         parseExpression(pVariable, local_context, model, false));
   Instruction::shared_ptr body =
       parseInstruction(pBody->FirstChildElement(), local_context, model);
-  return belem::Factory::makeVarIn(variables, body);
+  return b_factory_.makeVarIn(variables, body);
 }
 
 OperationCall::shared_ptr Parser::parseOperationCall(
@@ -759,7 +828,7 @@ OperationCall::shared_ptr Parser::parseOperationCall(
          pOut = pOut->NextSiblingElement())
       outputs.emplace_back(parseExpression(pOut, context, model));
   OperationCall::shared_ptr call =
-      belem::Factory::makeOperationCall(name, inputs, outputs);
+      b_factory_.makeOperationCall(name, inputs, outputs);
 
   if (not operations_.contains(name)) throw IdentifierOutOfScope(name);
   Operation::shared_ptr operation = operations_[name];
@@ -807,7 +876,7 @@ Loop::shared_ptr Parser::parseLoop(XMLElement *pLoop,
   model->add(s_factory_.makeAssertEquals(variant->getAssociatedVariable(),
                                          s_factory_.makeInteger()));
 
-  return belem::Factory::makeLoop(condition, body, invariant, variant);
+  return b_factory_.makeLoop(condition, body, invariant, variant);
 }
 
 QuantifiedPred::shared_ptr Parser::parseQuantifiedPred(
@@ -823,7 +892,7 @@ QuantifiedPred::shared_ptr Parser::parseQuantifiedPred(
         parseExpression(pVariable, new_context, model, false));
   Predicate::shared_ptr body = parsePredicate(pBody, new_context, model);
   QuantifiedPred::shared_ptr quantified_pred =
-      belem::Factory::makeQuantifiedPred(op, variables, body);
+      b_factory_.makeQuantifiedPred(op, variables, body);
   return quantified_pred;
 }
 
@@ -838,7 +907,7 @@ BinaryPred::shared_ptr Parser::parseBinaryPred(XMLElement *pPred,
   Predicate::shared_ptr left = parsePredicate(pLeft, context, model);
   Predicate::shared_ptr right = parsePredicate(pRight, context, model);
   BinaryPred::shared_ptr binary_pred =
-      belem::Factory::makeBinaryPred(left, op, right);
+      b_factory_.makeBinaryPred(left, op, right);
   return binary_pred;
 }
 
@@ -854,242 +923,13 @@ BinaryExp::shared_ptr Parser::parseBinaryExpression(XMLElement *pExp,
   Expression::shared_ptr left = parseExpression(pLeft, context, model);
   Expression::shared_ptr right = parseExpression(pRight, context, model);
   BinaryExp::shared_ptr bin_exp =
-      belem::Factory::makeBinaryExp(left, op, right, pos);
+      b_factory_.makeBinaryExp(left, op, right, pos);
   addExpression(model, bin_exp);
-  if (op == "*s") {
-    Variable::shared_ptr t1 = VarGenerator::getNewVariable();
-    Variable::shared_ptr t2 = VarGenerator::getNewVariable();
-    model->add(t1);
-    model->add(t2);
-    // The type of left must be of shape POW(t1)
-    model->add(s_factory_.makeAssertEquals(left->getAssociatedVariable(),
-                                           s_factory_.makeBPow(t1)));
-    // The type of right must be of shape POW(t2)
-    model->add(s_factory_.makeAssertEquals(right->getAssociatedVariable(),
-                                           s_factory_.makeBPow(t2)));
-    // The type of the binary operation is t1 x t2 where POW(t1) POW(t2) are the
-    // types of left and right
-    model->add(s_factory_.makeAssertEquals(
-        bin_exp->getAssociatedVariable(),
-        s_factory_.makeBPow(s_factory_.makeBCartesianProduct(t1, t2))));
-  } else if (op == "^") {
-    // Both operands must be sequences
-    Variable::shared_ptr t1 = addSequenceTypeConstraint(model, left);
-    Variable::shared_ptr t2 = addSequenceTypeConstraint(model, right);
-    // They also must have the same type
-    model->add(s_factory_.makeAssertEquals(t1, t2));
-    // The result will have the same type as the operands
-    model->add(s_factory_.makeAssertEquals(bin_exp->getAssociatedVariable(),
-                                           left->getAssociatedVariable()));
-  } else if (op == "->") {
-    // The right operand must be a sequence
-    Variable::shared_ptr t = addSequenceTypeConstraint(model, right);
-    // The left operand must be of type t
-    model->add(s_factory_.makeAssertEquals(left->getAssociatedVariable(), t));
-    // The type of the expression is the same as the right operand
-    model->add(s_factory_.makeAssertEquals(bin_exp->getAssociatedVariable(),
-                                           right->getAssociatedVariable()));
-  } else if (op == "<-") {
-    // The left operand must be a sequence
-    Variable::shared_ptr t = addSequenceTypeConstraint(model, left);
-    // The right operand must be of type t
-    model->add(s_factory_.makeAssertEquals(right->getAssociatedVariable(), t));
-    // The type of the expression is the same as the left operand
-    model->add(s_factory_.makeAssertEquals(bin_exp->getAssociatedVariable(),
-                                           left->getAssociatedVariable()));
-  } else if (op == "/|\\" or op == "\\|/") {
-    // The left operand must be a sequence
-    Variable::shared_ptr t = addSequenceTypeConstraint(model, left);
-    // The right operand must be an integer
-    model->add(s_factory_.makeAssertEquals(right->getAssociatedVariable(),
-                                           s_factory_.makeInteger()));
-    // The type of the expression is the same as the left operand
-    model->add(s_factory_.makeAssertEquals(bin_exp->getAssociatedVariable(),
-                                           left->getAssociatedVariable()));
-  } else if (op == "..") {
-    // Both operands should be integers
-    model->add(s_factory_.makeAssertEquals(right->getAssociatedVariable(),
-                                           s_factory_.makeInteger()));
-    model->add(s_factory_.makeAssertEquals(left->getAssociatedVariable(),
-                                           s_factory_.makeInteger()));
-    // The type of the expression must be POW(INTEGER)
-    model->add(s_factory_.makeAssertEquals(
-        bin_exp->getAssociatedVariable(),
-        s_factory_.makeBPow(s_factory_.makeInteger())));
-  } else if (op == "-s" or op == "/\\" or op == "\\/") {
-    // Both operands must be sets
-    addSetTypeConstraint(model, left);
-    addSetTypeConstraint(model, right);
-    // Both operands must have the same type
-    model->add(s_factory_.makeAssertEquals(left->getAssociatedVariable(),
-                                           right->getAssociatedVariable()));
-    // The expression must have the type of one of the operands
-    model->add(s_factory_.makeAssertEquals(left->getAssociatedVariable(),
-                                           bin_exp->getAssociatedVariable()));
-  } else if (op == "*i" or op == "**i" or op == "+i" or op == "-i" or
-             op == "/i" or op == "mod") {
-    // Right and left operand must have the same type
-    model->add(s_factory_.makeAssertEquals(left->getAssociatedVariable(),
-                                           right->getAssociatedVariable()));
-    // The type of the binary expression is the same as the operands
-    model->add(s_factory_.makeAssertEquals(left->getAssociatedVariable(),
-                                           bin_exp->getAssociatedVariable()));
-    // The type of the binary expression is integer
-    model->add(s_factory_.makeAssertEquals(bin_exp->getAssociatedVariable(),
-                                           s_factory_.makeInteger()));
-  } else if (op == "*r" or op == "**r" or op == "+r" or op == "-r" or
-             op == "/r") {
-    // Right and left operand must have the same type
-    model->add(s_factory_.makeAssertEquals(left->getAssociatedVariable(),
-                                           right->getAssociatedVariable()));
-    // The type of the binary expression is the same as the operands
-    model->add(s_factory_.makeAssertEquals(left->getAssociatedVariable(),
-                                           bin_exp->getAssociatedVariable()));
-    // The type of the binary expression is real
-    model->add(s_factory_.makeAssertEquals(bin_exp->getAssociatedVariable(),
-                                           s_factory_.makeReal()));
-  } else if (op == "*f" or op == "+f" or op == "-f" or op == "/f") {
-    // Right and left operand must have the same type
-    model->add(s_factory_.makeAssertEquals(left->getAssociatedVariable(),
-                                           right->getAssociatedVariable()));
-    // The type of the binary expression is the same as the operands
-    model->add(s_factory_.makeAssertEquals(left->getAssociatedVariable(),
-                                           bin_exp->getAssociatedVariable()));
-    // The type of the binary expression is float
-    model->add(s_factory_.makeAssertEquals(bin_exp->getAssociatedVariable(),
-                                           s_factory_.makeBIdent("FLOAT")));
-  } else if (op == "|->" or op == ",") {
-    // The expression is of type T x U assuming the left and right operands are
-    // of type T and U
-    model->add(s_factory_.makeAssertEquals(
-        bin_exp->getAssociatedVariable(),
-        s_factory_.makeBCartesianProduct(left->getAssociatedVariable(),
-                                         right->getAssociatedVariable())));
-  } else if (op == "<->") {
-    // Left and right operands must be sets
-    Variable::shared_ptr t = addSetTypeConstraint(model, left);
-    Variable::shared_ptr u = addSetTypeConstraint(model, right);
-    // The expression must be of type POW(POW(t1 x t2))
-    model->add(s_factory_.makeAssertEquals(
-        bin_exp->getAssociatedVariable(),
-        s_factory_.makeBPow(
-            s_factory_.makeBPow(s_factory_.makeBCartesianProduct(t, u)))));
-  } else if (op == "prj1") {
-    // Left and right operands must be sets
-    Variable::shared_ptr t = addSetTypeConstraint(model, left);
-    Variable::shared_ptr u = addSetTypeConstraint(model, right);
-    // The expression must be of type POW(t x u x t)
-    model->add(s_factory_.makeAssertEquals(
-        bin_exp->getAssociatedVariable(),
-        s_factory_.makeBPow(s_factory_.makeBCartesianProduct({t, u, t}))));
-  } else if (op == "prj2") {
-    // Left and right operands must be sets
-    Variable::shared_ptr t = addSetTypeConstraint(model, left);
-    Variable::shared_ptr u = addSetTypeConstraint(model, right);
-    // The expression must be of type POW(t x u x u)
-    model->add(s_factory_.makeAssertEquals(
-        bin_exp->getAssociatedVariable(),
-        s_factory_.makeBPow(s_factory_.makeBCartesianProduct({t, u, u}))));
-  } else if (op == ";") {
-    // Left operand must be of type POW(t x u1)
-    auto [t, u1] = addRelationTypeConstraint(model, left);
-    // Right operand should be of type POW(u2 x v)
-    auto [u2, v] = addRelationTypeConstraint(model, right);
-    // u1 and u2 must be the same
-    model->add(s_factory_.makeAssertEquals(u1, u2));
-    // The expression is of type POW(t x V)
-    model->add(s_factory_.makeAssertEquals(
-        bin_exp->getAssociatedVariable(),
-        s_factory_.makeBPow(s_factory_.makeBCartesianProduct(t, v))));
-  } else if (op == "><") {
-    // The left operand must be of type POW(t1 x u)
-    auto [t1, u] = addRelationTypeConstraint(model, left);
-    // The right operand must be of type POW(t2 x v)
-    const auto [t2, v] = addRelationTypeConstraint(model, right);
-    // t1 and t2 must be equals
-    model->add(s_factory_.makeAssertEquals(t1, t2));
-    // The expression is of type POW(t1 x (u x v))
-    model->add(s_factory_.makeAssertEquals(
-        bin_exp->getAssociatedVariable(),
-        s_factory_.makeBPow(s_factory_.makeBCartesianProduct(
-            t1, s_factory_.makeBCartesianProduct(u, v)))));
-  } else if (op == "||") {
-    // The left operand must be of type POW(t x u)
-    auto [t, u] = addRelationTypeConstraint(model, left);
-    // The right operand must be of type POW(v x w)
-    auto [v, w] = addRelationTypeConstraint(model, right);
-    model->add(s_factory_.makeAssertEquals(
-        bin_exp->getAssociatedVariable(),
-        s_factory_.makeBPow(s_factory_.makeBCartesianProduct(
-            s_factory_.makeBCartesianProduct(t, v),
-            s_factory_.makeBCartesianProduct(u, w)))));
-  } else if (op == "iterate") {
-    // The left operand must be of type POW(T x T)
-    auto [t, u] = addRelationTypeConstraint(model, left);
-    model->add(s_factory_.makeAssertEquals(t, u));
-    // The right operand must be an integer
-    model->add(s_factory_.makeAssertEquals(right->getAssociatedVariable(),
-                                           s_factory_.makeInteger()));
-    // The type of the expression is also POW(T x T)
-    model->add(s_factory_.makeAssertEquals(bin_exp->getAssociatedVariable(),
-                                           left->getAssociatedVariable()));
-
-  } else if (op == "[") {
-    // The type of the left operand must be POW(t,u)
-    auto [t1, u] = addRelationTypeConstraint(model, left);
-    // The type of the right operand must be POW(t)
-    Variable::shared_ptr t2 = addSetTypeConstraint(model, right);
-    model->add(s_factory_.makeAssertEquals(t1, t2));
-    // The expression is of type POW(u)
-    model->add(s_factory_.makeAssertEquals(bin_exp->getAssociatedVariable(),
-                                           s_factory_.makeBPow(u)));
-
-  } else if (op == "<<|" or op == "<|") {
-    // Left operand must be a set of type POW(t)
-    Variable::shared_ptr t1 = addSetTypeConstraint(model, left);
-    // Right operand must be of type POW(t x u)
-    auto [t2, u] = addRelationTypeConstraint(model, right);
-    model->add(s_factory_.makeAssertEquals(t1, t2));
-    // The expression is also of type POW(t x u)
-    model->add(s_factory_.makeAssertEquals(bin_exp->getAssociatedVariable(),
-                                           right->getAssociatedVariable()));
-  } else if (op == "|>" or op == "|>>") {
-    // Left operand must be of type POW(t x u)
-    auto [t, u1] = addRelationTypeConstraint(model, left);
-    // Right operand must be of type POW(u)
-    Variable::shared_ptr u2 = addSetTypeConstraint(model, right);
-    model->add(s_factory_.makeAssertEquals(u1, u2));
-    // The expression is also of type POW(t x u)
-  } else if (op == "<+") {
-    // Left and right operands must be of type POW(t x u)
-    auto [t1, u1] = addRelationTypeConstraint(model, left);
-    auto [t2, u2] = addRelationTypeConstraint(model, right);
-    model->add(s_factory_.makeAssertEquals(t1, t2));
-    model->add(s_factory_.makeAssertEquals(u1, u2));
-    // The expression is also of type POW(t x u)
-    model->add(s_factory_.makeAssertEquals(bin_exp->getAssociatedVariable(),
-                                           left->getAssociatedVariable()));
-  } else if (op == "-->" or op == "+->" or op == ">+>" or op == ">->" or
-             op == "+->>" or op == "-->>" or op == ">->>") {
-    // Left operand should be of type POW(t)
-    Variable::shared_ptr t = addSetTypeConstraint(model, left);
-    // Right operand should be of type POW(u)
-    Variable::shared_ptr u = addSetTypeConstraint(model, right);
-    // The expression is of type POW(POW(t x u))
-    model->add(s_factory_.makeAssertEquals(
-        bin_exp->getAssociatedVariable(),
-        s_factory_.makeBPow(
-            s_factory_.makeBPow(s_factory_.makeBCartesianProduct(t, u)))));
-  } else if (op == "(") {
-    // Left operand must be a function of type POW(t x u)
-    auto [t, u] = addRelationTypeConstraint(model, left);
-    // Right operand is of type t
-    model->add(s_factory_.makeAssertEquals(t, right->getAssociatedVariable()));
-    // The expression is of type u
-    model->add(
-        s_factory_.makeAssertEquals(bin_exp->getAssociatedVariable(), u));
-  } else
+  const typing::Rule *rule =
+      typing::findRule(typing::binary_rules, computeOperator(op));
+  if (rule == nullptr)
     throw UnknownXmlElement("<Binary_Exp op=\"" + op + "\">");
+  addTypingRule(model, *rule, {bin_exp, left, right});
 
   return bin_exp;
 }
@@ -1106,168 +946,13 @@ UnaryExp::shared_ptr Parser::parseUnaryExpression(XMLElement *pUnaryExp,
   else
     pArg = pUnaryExp->FirstChildElement();
   Expression::shared_ptr arg = parseExpression(pArg, context, model);
-  UnaryExp::shared_ptr unary_exp = belem::Factory::makeUnaryExp(op, arg, pos);
+  UnaryExp::shared_ptr unary_exp = b_factory_.makeUnaryExp(op, arg, pos);
   addExpression(model, unary_exp);
-  if (op == "-i" or op == "succ" or op == "pred") {
-    // For those operators, the argument must be an integer
-    model->add(s_factory_.makeAssertEquals(arg->getAssociatedVariable(),
-                                           s_factory_.makeInteger()));
-    // The type of the unary expression is the same as its argument
-    model->add(s_factory_.makeAssertEquals(unary_exp->getAssociatedVariable(),
-                                           arg->getAssociatedVariable()));
-  } else if (op == "real") {
-    // The argument must be of type integer
-    model->add(s_factory_.makeAssertEquals(arg->getAssociatedVariable(),
-                                           s_factory_.makeInteger()));
-    // The result of the application is an real
-    model->add(s_factory_.makeAssertEquals(unary_exp->getAssociatedVariable(),
-                                           s_factory_.makeReal()));
-  } else if (op == "floor" or op == "ceiling") {
-    // The argument must be of type real
-    model->add(s_factory_.makeAssertEquals(arg->getAssociatedVariable(),
-                                           s_factory_.makeReal()));
-    // The result of the application is an integer
-    model->add(s_factory_.makeAssertEquals(unary_exp->getAssociatedVariable(),
-                                           s_factory_.makeInteger()));
-  } else if (op == "imax" or op == "imin") {
-    // The argument must be a set of integers
-    model->add(s_factory_.makeAssertEquals(
-        arg->getAssociatedVariable(),
-        s_factory_.makeBPow(s_factory_.makeInteger())));
-    // The result of the application is an integer
-    model->add(s_factory_.makeAssertEquals(unary_exp->getAssociatedVariable(),
-                                           s_factory_.makeInteger()));
-  } else if (op == "rmax" or op == "rmin") {
-    // The argument must be a set of reals
-    model->add(s_factory_.makeAssertEquals(
-        arg->getAssociatedVariable(),
-        s_factory_.makeBPow(s_factory_.makeReal())));
-    // The result of the application is a real
-    model->add(s_factory_.makeAssertEquals(unary_exp->getAssociatedVariable(),
-                                           s_factory_.makeReal()));
-  } else if (op == "card") {
-    // The argument must be a set
-    addSetTypeConstraint(model, arg);
-    // The result of the application is an integer
-    model->add(s_factory_.makeAssertEquals(unary_exp->getAssociatedVariable(),
-                                           s_factory_.makeInteger()));
-  } else if (op == "POW" or op == "POW1" or op == "FIN" or op == "FIN1") {
-    // The argument must be a set of type POW(t)
-    Variable::shared_ptr t = addSetTypeConstraint(model, arg);
-    // The type of the expression is POW(arg)
-    model->add(s_factory_.makeAssertEquals(
-        unary_exp->getAssociatedVariable(),
-        s_factory_.makeBPow(arg->getAssociatedVariable())));
-  } else if (op == "seq" or op == "seq1" or op == "iseq" or op == "iseq1" or
-             op == "perm") {
-    // Creating a fresh variable and adding it to the model
-    Variable::shared_ptr var_type = VarGenerator::getNewVariable();
-    model->add(var_type);
-    // The argument of these operators must have a type of shape POW(T)
-    model->add(s_factory_.makeAssertEquals(arg->getAssociatedVariable(),
-                                           s_factory_.makeBPow(var_type)));
-    // The type of the expression must be POW(POW(INTEGER x T))
-    model->add(s_factory_.makeAssertEquals(
-        unary_exp->getAssociatedVariable(),
-        s_factory_.makeBPow(
-            s_factory_.makeBPow(s_factory_.makeBCartesianProduct(
-                s_factory_.makeInteger(), var_type)))));
-  } else if (op == "size") {
-    addSequenceTypeConstraint(model, arg);
-    // The unary expression type must be INTEGER
-    model->add(s_factory_.makeAssertEquals(unary_exp->getAssociatedVariable(),
-                                           s_factory_.makeInteger()));
-  } else if (op == "first" or op == "last") {
-    Variable::shared_ptr t = addSequenceTypeConstraint(model, arg);
-    // The unary expression type must be t
-    model->add(
-        s_factory_.makeAssertEquals(unary_exp->getAssociatedVariable(), t));
-  } else if (op == "front" or op == "tail" or op == "rev") {
-    addSequenceTypeConstraint(model, arg);
-    // The type of the unary expression must be the same as its argument
-    model->add(s_factory_.makeAssertEquals(unary_exp->getAssociatedVariable(),
-                                           arg->getAssociatedVariable()));
-  } else if (op == "conc") {
-    Variable::shared_ptr t = VarGenerator::getNewVariable();
-    // The argument must be of type POW(INTEGER x POW(INTEGER x t))
-    model->add(s_factory_.makeAssertEquals(
-        arg->getAssociatedVariable(),
-        s_factory_.makeBPow(s_factory_.makeBCartesianProduct(
-            s_factory_.makeInteger(),
-            s_factory_.makeBPow(s_factory_.makeBCartesianProduct(
-                s_factory_.makeInteger(), t))))));
-    // The type of the unary expression must be POW(INTEGER, t)
-    model->add(s_factory_.makeAssertEquals(
-        unary_exp->getAssociatedVariable(),
-        s_factory_.makeBPow(
-            s_factory_.makeBCartesianProduct(s_factory_.makeInteger(), t))));
-
-  } else if (op == "union" or op == "inter") {
-    // The result must be a set of type POW(t)
-    Variable::shared_ptr t = addSetTypeConstraint(model, unary_exp);
-    // The argument sould be a set of set of type POW(POW(t))
-    model->add(s_factory_.makeAssertEquals(
-        arg->getAssociatedVariable(),
-        s_factory_.makeBPow(unary_exp->getAssociatedVariable())));
-  } else if (op == "id") {
-    // The argument must be a set of type POW(t)
-    Variable::shared_ptr t = addSetTypeConstraint(model, arg);
-    // Thus, the expression is of type POW(t x t)
-    model->add(s_factory_.makeAssertEquals(
-        unary_exp->getAssociatedVariable(),
-        s_factory_.makeBPow(s_factory_.makeBCartesianProduct(t, t))));
-  } else if (op == "~") {
-    // The argument must be of type POW(t x u)
-    Variable::shared_ptr t = VarGenerator::getNewVariable();
-    Variable::shared_ptr u = VarGenerator::getNewVariable();
-    model->add(u);
-    model->add(t);
-    model->add(s_factory_.makeAssertEquals(
-        arg->getAssociatedVariable(),
-        s_factory_.makeBPow(s_factory_.makeBCartesianProduct(t, u))));
-    // The expression must be of type POW(u x t)
-    model->add(s_factory_.makeAssertEquals(
-        unary_exp->getAssociatedVariable(),
-        s_factory_.makeBPow(s_factory_.makeBCartesianProduct(u, t))));
-  } else if (op == "closure" or op == "closure1") {
-    // The argument must be of type POW(t x t)
-    auto [t1, t2] = addRelationTypeConstraint(model, arg);
-    model->add(s_factory_.makeAssertEquals(t1, t2));
-    // The expression has the same type as the argument
-    model->add(s_factory_.makeAssertEquals(unary_exp->getAssociatedVariable(),
-                                           arg->getAssociatedVariable()));
-  } else if (op == "dom") {
-    // The argument must be of type POW(t x u)
-    auto [t, u] = addRelationTypeConstraint(model, arg);
-    // The expression must be of type POW(t)
-    model->add(s_factory_.makeAssertEquals(unary_exp->getAssociatedVariable(),
-                                           s_factory_.makeBPow(t)));
-  } else if (op == "ran") {
-    // The argument must be of type POW(t x u)
-    auto [t, u] = addRelationTypeConstraint(model, arg);
-    // The expression must be of type POW(u)
-    model->add(s_factory_.makeAssertEquals(unary_exp->getAssociatedVariable(),
-                                           s_factory_.makeBPow(u)));
-  } else if (op == "fnc") {
-    // The argument must be of type POW(t x u)
-    auto [t, u] = addRelationTypeConstraint(model, arg);
-    // The expression must be of type POW(t x POW(u))
-    model->add(s_factory_.makeAssertEquals(
-        unary_exp->getAssociatedVariable(),
-        s_factory_.makeBPow(
-            s_factory_.makeBCartesianProduct(t, s_factory_.makeBPow(u)))));
-  } else if (op == "rel") {
-    // The argument must be of type POW(t x POW(u))
-    auto [t, pow_u] = addRelationTypeConstraint(model, arg);
-    Variable::shared_ptr u = VarGenerator::getNewVariable();
-    model->add(u);
-    model->add(s_factory_.makeAssertEquals(pow_u, s_factory_.makeBPow(u)));
-    // The type of the expression in POW(t x u)
-    model->add(s_factory_.makeAssertEquals(
-        unary_exp->getAssociatedVariable(),
-        s_factory_.makeBPow(s_factory_.makeBCartesianProduct(t, u))));
-  } else
+  const typing::Rule *rule =
+      typing::findRule(typing::unary_rules, computeOperator(op));
+  if (rule == nullptr)
     throw UnknownXmlElement("<Unary_Exp op=\"" + op + "\">");
+  addTypingRule(model, *rule, {unary_exp, arg, nullptr});
 
   return unary_exp;
 }
@@ -1283,7 +968,7 @@ BooleanExpression::shared_ptr Parser::parseBooleanExpression(
     pPred = pBool->FirstChildElement();
   Predicate::shared_ptr pred = parsePredicate(pPred, context, model);
   BooleanExpression::shared_ptr bool_exp =
-      belem::Factory::makeBooleanExp(pred, position);
+      b_factory_.makeBooleanExp(pred, position);
   addExpression(model, bool_exp);
   // The result of the application is a bool
   model->add(s_factory_.makeAssertEquals(bool_exp->getAssociatedVariable(),
@@ -1308,7 +993,7 @@ NaryExp::shared_ptr Parser::parseNaryExpression(XMLElement *pExp,
     operands.emplace_back(parseExpression(pOperand, context, model));
 
   NaryExp::shared_ptr nary_exp =
-      belem::Factory::makeNaryExp(operands, op, position);
+      b_factory_.makeNaryExp(operands, op, position);
   addExpression(model, nary_exp);
   if (operands.size() != 0) {
     Variable::shared_ptr type = operands[0]->getAssociatedVariable();
@@ -1337,7 +1022,7 @@ NaryExp::shared_ptr Parser::parseNaryExpression(XMLElement *pExp,
 NaryExp::shared_ptr Parser::parseEmptySeq(Context::shared_ptr context,
                                           Model::shared_ptr model,
                                           Position::shared_ptr pos) {
-  NaryExp::shared_ptr empty_seq = belem::Factory::makeNaryExp({}, "[", pos);
+  NaryExp::shared_ptr empty_seq = b_factory_.makeNaryExp({}, "[", pos);
   addExpression(model, empty_seq);
   return empty_seq;
 }
@@ -1345,7 +1030,7 @@ NaryExp::shared_ptr Parser::parseEmptySeq(Context::shared_ptr context,
 NaryExp::shared_ptr Parser::parseEmptySet(Context::shared_ptr context,
                                           Model::shared_ptr model,
                                           Position::shared_ptr pos) {
-  NaryExp::shared_ptr empty_set = belem::Factory::makeNaryExp({}, "{", pos);
+  NaryExp::shared_ptr empty_set = b_factory_.makeNaryExp({}, "{", pos);
   addExpression(model, empty_set);
   return empty_set;
 }
@@ -1364,7 +1049,7 @@ QuantifiedSet::shared_ptr Parser::parseQuantifiedSet(
   Predicate::shared_ptr predicate =
       parsePredicate(pBody->FirstChildElement(), new_context, model);
   QuantifiedSet::shared_ptr quantified_set =
-      belem::Factory::makeQuantifiedSet(variables, predicate, pos);
+      b_factory_.makeQuantifiedSet(variables, predicate, pos);
   addExpression(model, quantified_set);
   // The type of the set is POW(t1 x ... x tn) assuming the expressions are of
   // type t1, ..., tn
@@ -1398,7 +1083,7 @@ QuantifiedExp::shared_ptr Parser::parseQuantifiedExp(
   Predicate::shared_ptr pred = parsePredicate(pPred, new_context, model);
   Expression::shared_ptr body = parseExpression(pBody, new_context, model);
   QuantifiedExp::shared_ptr quantified_exp =
-      belem::Factory::makeQuantifiedExp(type, variables, pred, body, pos);
+      b_factory_.makeQuantifiedExp(type, variables, pred, body, pos);
   addExpression(model, quantified_exp);
   if (type == "iSIGMA" or type == "iPI") {
     // The type of the expression must be integer
@@ -1447,10 +1132,12 @@ Valuation::shared_ptr Parser::parseValuation(XMLElement *pValuation,
     pVal = pPos->NextSiblingElement();
   else
     pVal = pValuation->FirstChildElement();
-  Expression::shared_ptr var = context->get(pValuation->Attribute("ident"));
+  const char *ident = pValuation->Attribute("ident");
+  Expression::shared_ptr var = context->find(symbols_->intern(ident));
+  if (var == nullptr) throw IdentifierOutOfScope(ident);
   Expression::shared_ptr val = parseExpression(pVal, context, model);
   Valuation::shared_ptr valuation =
-      belem::Factory::makeValuation(var, val, pos);
+      b_factory_.makeValuation(var, val, pos);
   addExpression(model, valuation);
   // The type of the valuation is the same as its value and variable
   model->add(s_factory_.makeAssertEquals(valuation->getAssociatedVariable(),
@@ -1494,7 +1181,7 @@ Operation::shared_ptr Parser::parseOperation(XMLElement *pOp,
     args_types.emplace_back(output->getAssociatedVariable());
   Variable::shared_ptr var = VarGenerator::getNewVariable();
   model->add(var);
-  Operation::shared_ptr operation = belem::Factory::makeOperation(
+  Operation::shared_ptr operation = b_factory_.makeOperation(
       name, inputs, outputs, precondition, body, var);
   // The operation is of type POW(Input x Output)
   if (args_types.size() == 1)
@@ -1601,4 +1288,68 @@ Parser::addRelationTypeConstraint(Model::shared_ptr model,
   return {t, u};
 }
 
+void Parser::addTypingRule(Model::shared_ptr model, const typing::Rule &rule,
+                           const array<Expression::shared_ptr, 3> &operands) {
+  array<Variable::shared_ptr, typing::slot_count> slots;
+  for (size_t i = 0; i < rule.size; i++) {
+    const typing::Step &step = rule.steps[i];
+    switch (step.action) {
+      case typing::Action::Fresh:
+        slots[step.slots[0]] = VarGenerator::getNewVariable();
+        model->add(slots[step.slots[0]]);
+        break;
+      case typing::Action::Set:
+        slots[step.slots[0]] =
+            addSetTypeConstraint(model, operands[step.operand]);
+        break;
+      case typing::Action::Sequence:
+        slots[step.slots[0]] =
+            addSequenceTypeConstraint(model, operands[step.operand]);
+        break;
+      case typing::Action::Relation:
+        std::tie(slots[step.slots[0]], slots[step.slots[1]]) =
+            addRelationTypeConstraint(model, operands[step.operand]);
+        break;
+      case typing::Action::Equal: {
+        size_t left = 0;
+        size_t right = 0;
+        model->add(s_factory_.makeAssertEquals(
+            instantiate(step.left, left, operands, slots),
+            instantiate(step.right, right, operands, slots)));
+        break;
+      }
+    }
+  }
+}
+
+AbstractBType::shared_ptr Parser::instantiate(
+    const typing::Signature &signature, size_t &position,
+    const array<Expression::shared_ptr, 3> &operands,
+    const array<Variable::shared_ptr, typing::slot_count> &slots) {
+  const typing::Symbol &symbol = signature.symbols[position++];
+  switch (symbol.node) {
+    case typing::Node::Integer:
+      return s_factory_.makeInteger();
+    case typing::Node::Real:
+      return s_factory_.makeReal();
+    case typing::Node::Float:
+      return s_factory_.makeBIdent("FLOAT");
+    case typing::Node::Pow:
+      return s_factory_.makeBPow(
+          instantiate(signature, position, operands, slots));
+    case typing::Node::Product: {
+      AbstractBType::shared_ptr left =
+          instantiate(signature, position, operands, slots);
+      AbstractBType::shared_ptr right =
+          instantiate(signature, position, operands, slots);
+      return s_factory_.makeBCartesianProduct(left, right);
+    }
+    case typing::Node::Operand:
+      return operands[symbol.index]->getAssociatedVariable();
+    case typing::Node::Slot:
+      return slots[symbol.index];
+  }
+  return nullptr;
+}
+
 }  // namespace genericparser
@@ -24,8 +24,13 @@
  */
 #include "pogparser.h"
 
+#include <algorithm>
+#include <exception>
+#include <future>
 #include <iostream>
 
+#include "session.h"
+#include "threadpool.h"
 #include "vargen.h"
 
 using namespace tinyxml2;
@@ -33,9 +38,15 @@ using namespace tinyxml2;
 using belem::Expression;
 using genericparser::Context;
 using solver::Model;
+using solver::Session;
+using solver::VarGenerator;
+using solver::Variable;
+using std::future;
 using std::make_shared;
+using std::move;
 using std::pair;
 using std::string;
+using std::unordered_set;
 using std::vector;
 
 namespace pog {
@@ -50,7 +61,14 @@ Context::shared_ptr Parser::parse(XMLDocument *pDocument) {
 
   parseProofObligations(pPo);
 
-  context->SetModels(models_);
+  if (enable_incremental_solving_ or enable_defines_seeding_) {
+    // The Define model is shared by the proof obligations instead of being
+    // merged into each one
+    context->setBaseModel(models_[0]);
+    context->SetModels(vector<Model::shared_ptr>(models_.begin() + 1,
+                                                 models_.end()));
+  } else
+    context->SetModels(models_);
   context->setExpressions(expressions_);
 
   return context;
@@ -83,23 +101,85 @@ void Parser::parseDefines(XMLElement *pPo) {
     def_to_context_[pDefine->Attribute("name")] = local_context;
   }
 
-  if (enable_multi_thread_)
+  if (enable_multi_thread_ and not enable_incremental_solving_ and
+      not enable_defines_seeding_)
     for (unsigned int i = 1; i < models_.size(); i++)
       models_[i]->merge(models_[0]);
 }
 
 void Parser::parseProofObligations(XMLElement *pPos) {
-  int i = 1;
+  vector<XMLElement *> pos;
   for (XMLElement *pPo = pPos->FirstChildElement("Proof_Obligation");
-       pPo != nullptr; pPo = pPo->NextSiblingElement("Proof_Obligation")) {
-    sets_ = {};
-    relations_ = {};
-    sequences_ = {};
-    if (enable_multi_thread_)
-      parseProofObligation(pPos, pPo, models_[i++]);
-    else
+       pPo != nullptr; pPo = pPo->NextSiblingElement("Proof_Obligation"))
+    pos.push_back(pPo);
+
+  if (not enable_multi_thread_) {
+    for (XMLElement *pPo : pos) {
+      sets_ = {};
+      relations_ = {};
+      sequences_ = {};
       parseProofObligation(pPos, pPo, models_[0]);
+    }
+    return;
+  }
+
+  // The expressions of the definitions are declared by the global model, they
+  // are only read by the workers
+  unordered_set<Expression::shared_ptr> shared = move(expressions_);
+  expressions_ = {};
+  // The names of the definitions are looked up by the workers without locking
+  symbols_->freeze();
+  // The workers create their variables in the session of the caller, taking
+  // their ids in whatever order they reach its counter. They record their
+  // variables, which are numbered again in the order of the proof obligations
+  // once joined.
+  Session::shared_ptr session = Session::getCurrent();
+  int first = session->getVariableCount();
+  tools::ThreadPool &pool = tools::ThreadPool::getShared();
+  size_t range_count = std::min<size_t>(pool.size(), pos.size());
+  vector<vector<Variable::shared_ptr>> generated(range_count);
+  vector<Parser::shared_ptr> workers;
+  vector<future<void>> futures;
+  for (size_t range = 0; range < range_count; range++) {
+    size_t begin = range * pos.size() / range_count;
+    size_t end = (range + 1) * pos.size() / range_count;
+    // Each worker owns its copy of the factory, the sets and the local
+    // hypotheses
+    Parser::shared_ptr worker = make_shared<Parser>(*this);
+    worker->shared_expressions_ = &shared;
+    workers.push_back(worker);
+    futures.push_back(pool.submit([this, worker, session, pPos, &pos, begin,
+                                   end, &variables = generated[range]] {
+      Session::Scope scope(session);
+      VarGenerator::Record record(variables);
+      for (size_t i = begin; i < end; i++) {
+        worker->sets_ = {};
+        worker->relations_ = {};
+        worker->sequences_ = {};
+        worker->parseProofObligation(pPos, pos[i], models_[i + 1]);
+      }
+    }));
   }
+
+  // Waiting for every worker before rethrowing since they reference shared
+  std::exception_ptr error;
+  for (future<void> &result : futures) {
+    try {
+      result.get();
+    } catch (...) {
+      if (not error) error = std::current_exception();
+    }
+  }
+  if (error) std::rethrow_exception(error);
+
+  for (const vector<Variable::shared_ptr> &variables : generated)
+    first = VarGenerator::renumber(variables, first);
+  for (const Parser::shared_ptr &worker : workers)
+    worker->s_factory_.updateAssertions();
+
+  expressions_ = move(shared);
+  for (const Parser::shared_ptr &worker : workers)
+    expressions_.merge(worker->expressions_);
 }
 
 void Parser::parseProofObligation(XMLElement *pPos, XMLElement *pPo,
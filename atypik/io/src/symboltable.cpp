@@ -0,0 +1,101 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#include "symboltable.h"
+
+#include <mutex>
+
+using std::move;
+using std::shared_lock;
+using std::string;
+using std::string_view;
+using std::unique_lock;
+
+namespace genericparser {
+
+size_t SymbolTable::Hash::operator()(string_view name) const {
+  return (*this)(Name{string_view(), name});
+}
+
+size_t SymbolTable::Hash::operator()(const Name& name) const {
+  // FNV-1a, whose value only depends on the characters of the whole name
+  size_t result = 14695981039346656037ull;
+  for (string_view part : {name.prefix, name.name})
+    for (char c : part) {
+      result ^= static_cast<unsigned char>(c);
+      result *= 1099511628211ull;
+    }
+  return result;
+}
+
+bool SymbolTable::Equal::operator()(string_view left, string_view right) const {
+  return left == right;
+}
+
+bool SymbolTable::Equal::operator()(string_view left, const Name& right) const {
+  return left.size() == right.prefix.size() + right.name.size() and
+         left.starts_with(right.prefix) and left.ends_with(right.name);
+}
+
+bool SymbolTable::Equal::operator()(const Name& left, string_view right) const {
+  return (*this)(right, left);
+}
+
+int SymbolTable::find(const Symbols& symbols, const Name& name) {
+  auto symbol = symbols.find(name);
+  return symbol != symbols.end() ? symbol->second : -1;
+}
+
+int SymbolTable::intern(string_view name) {
+  return intern(string_view(), name);
+}
+
+int SymbolTable::intern(string_view prefix, string_view name) {
+  Name key{prefix, name};
+  // The frozen names are not modified anymore
+  if (frozen_) {
+    int symbol = find(symbols_, key);
+    if (symbol >= 0) return symbol;
+  }
+  Symbols& symbols = frozen_ ? added_ : symbols_;
+  {
+    shared_lock lock(mutex_);
+    int symbol = find(symbols, key);
+    if (symbol >= 0) return symbol;
+  }
+  unique_lock lock(mutex_);
+  // The name may have been added since the shared lock was released
+  int symbol = find(symbols, key);
+  if (symbol >= 0) return symbol;
+  symbol = symbols_.size() + added_.size();
+  string whole;
+  whole.reserve(prefix.size() + name.size());
+  whole.append(prefix).append(name);
+  symbols.emplace(move(whole), symbol);
+  return symbol;
+}
+
+void SymbolTable::freeze() { frozen_ = true; }
+
+}  // namespace genericparser
@@ -28,6 +28,10 @@ using namespace tinyxml2;
 
 using belem::Expression;
 using belem::Set;
+using solver::AbstractBType;
+using solver::BCartesianProduct;
+using solver::BPow;
+using solver::Solution;
 using solver::Variable;
 using std::dynamic_pointer_cast;
 using std::pair;
@@ -42,7 +46,7 @@ namespace genericwriter
 {
   void Writer::write(XMLDocument *pDocument, string output,
                      unordered_set<Expression::shared_ptr> expressions,
-                     unordered_map<Variable::shared_ptr, string> var_to_type)
+                     const Solution &var_to_type)
   {
     for (auto &expression : expressions)
     {
@@ -62,7 +66,7 @@ namespace genericwriter
 
   void Writer::write(XMLDocument *pDocument,
                      unordered_set<Expression::shared_ptr> expressions,
-                     unordered_map<Variable::shared_ptr, string> var_to_type)
+                     const Solution &var_to_type)
   {
     for (auto &expression : expressions)
     {
@@ -82,169 +86,164 @@ namespace genericwriter
 
   void Writer::computeTypes()
   {
-    int id = sets_.size();
-    for (auto &[var, type] : var_to_type_)
+    // The sets come first, each one followed by its power set
+    for (auto &set : sets_)
     {
-      types_[type] = id++;
+      string name = set->getID()->format();
+      if (identifier_ids_.contains(name))
+        continue;
+      int id = addRichType({Kind::Set, name, -1, -1, set});
+      identifier_ids_[name] = id;
+      power_set_ids_[id] = addRichType({Kind::PowerSet, "", id, -1, nullptr});
     }
 
-    id = 0;
+    // The type of a set expression is written as the power set of the set
     unordered_set<string> added_sets;
-
     for (auto &set : sets_)
     {
-      if (added_sets.contains(set->getID()->format()))
+      string name = set->getID()->format();
+      if (not added_sets.insert(name).second)
         continue;
-      added_sets.insert(set->getID()->format());
-      // The type id
-      sets_to_types_[set->getID()->format()] = id++;
-      // The type POW(id)
-      sets_to_types_[var_to_type_[set->getAssociatedVariable()]] = id++;
+      AbstractBType::shared_ptr type =
+          var_to_type_.get(set->getAssociatedVariable());
+      if (type != nullptr)
+        setTypeId(type, power_set_ids_[identifier_ids_[name]]);
     }
-    addArgsTypes();
-  }
 
-  void Writer::addRichTypes()
-  {
-    for (auto expression : expressions_)
+    for (int id = 0; id < var_to_type_.size(); id++)
     {
-      string type = var_to_type_[expression->getAssociatedVariable()];
-      for (auto position : expression->getPositions())
-      {
-        XMLElement *pExpr = position->getTinyXMLElement();
-        int id = types_[var_to_type_[expression->getAssociatedVariable()]];
-        pExpr->SetAttribute(richtyperef_tag_, id);
-      }
+      AbstractBType::shared_ptr type = var_to_type_.get(id);
+      if (type != nullptr)
+        getTypeId(type);
     }
   }
 
-  void Writer::addArgsTypes()
+  int Writer::getTypeId(AbstractBType::shared_ptr type)
   {
-    vector<string> stack;
+    if (type_ids_.contains(type.get()))
+      return type_ids_[type.get()];
 
-    auto addArg = [this, &stack](string &arg)
+    // Structurally equal types built by different factories share their id
+    int id;
+    if (BPow::shared_ptr pow = dynamic_pointer_cast<BPow>(type))
     {
-      if (not types_.contains(arg))
-      {
-        stack.push_back(arg);
-        types_[arg] = types_.size();
-      }
-    };
-
-    for (const auto &[type, _] : types_)
-      if (not sets_to_types_.contains(type))
-        stack.push_back(type);
-
-    types_ = sets_to_types_;
-
-    while (not stack.empty())
+      int arg = getTypeId(pow->getType());
+      if (not power_set_ids_.contains(arg))
+        power_set_ids_[arg] =
+            addRichType({Kind::PowerSet, "", arg, -1, nullptr});
+      id = power_set_ids_[arg];
+    }
+    else if (BCartesianProduct::shared_ptr product =
+                 dynamic_pointer_cast<BCartesianProduct>(type))
     {
-      string type = stack.back();
-      stack.pop_back();
-
-      while (type.starts_with(' '))
-        type.erase(0, 1);
-
-      while (type.back() == ' ')
-        type.pop_back();
-
-      if (type.starts_with("(POW"))
-      {
-        string arg = getArgFromPow(type);
-        addArg(arg);
-      }
-      else if (type.starts_with("(PRODUCT"))
-      {
-        pair<string, string> args = getArgsFromCartesianProduct(type);
-        addArg(args.first);
-        addArg(args.second);
-      }
-
-      addArg(type);
+      pair<int, int> args = {getTypeId(product->getLeft()),
+                             getTypeId(product->getRight())};
+      if (not product_ids_.contains(args))
+        product_ids_[args] =
+            addRichType({Kind::Product, "", args.first, args.second, nullptr});
+      id = product_ids_[args];
+    }
+    else
+    {
+      string name = type->toSMT();
+      if (not identifier_ids_.contains(name))
+        identifier_ids_[name] =
+            addRichType({Kind::Identifier, name, -1, -1, nullptr});
+      id = identifier_ids_[name];
     }
+    type_ids_[type.get()] = id;
+    return id;
   }
 
-  void Writer::addRichTypesInfo()
+  void Writer::setTypeId(AbstractBType::shared_ptr type, int id)
   {
-    vector<string> types(types_.size());
-    int sets_index = 0;
+    if (BPow::shared_ptr pow = dynamic_pointer_cast<BPow>(type))
+      power_set_ids_[getTypeId(pow->getType())] = id;
+    else if (BCartesianProduct::shared_ptr product =
+                 dynamic_pointer_cast<BCartesianProduct>(type))
+      product_ids_[{getTypeId(product->getLeft()),
+                    getTypeId(product->getRight())}] = id;
+    else
+      identifier_ids_[type->toSMT()] = id;
+    type_ids_[type.get()] = id;
+  }
 
-    for (auto &[type, id] : types_)
+  int Writer::addRichType(RichType type)
+  {
+    types_.push_back(type);
+    return types_.size() - 1;
+  }
+
+  void Writer::addRichTypes()
+  {
+    for (auto expression : expressions_)
     {
-      if (sets_to_types_.contains(type))
-      {
-        ++sets_index;
+      AbstractBType::shared_ptr type =
+          var_to_type_.get(expression->getAssociatedVariable());
+      if (type == nullptr)
         continue;
+      int id = getTypeId(type);
+      for (auto position : expression->getPositions())
+      {
+        XMLElement *pExpr = position->getTinyXMLElement();
+        pExpr->SetAttribute(richtyperef_tag_, id);
       }
-      types[id] = type;
     }
+  }
 
+  void Writer::addRichTypesInfo()
+  {
     XMLElement *pTypesInfo = pDocument_->NewElement(richtypesinfo_tag_);
 
-    int index = 0;
-    unordered_set<string> added_sets;
-    for (auto set : sets_)
-    {
-      if (added_sets.contains(set->getID()->format()))
-        continue;
-      added_sets.insert(set->getID()->format());
-      XMLElement *pType = pDocument_->NewElement(type_tag_);
-      pType->SetAttribute(id_tag_, index++);
-      addSetType(pType, set);
-      pTypesInfo->LinkEndChild(pType);
-      pType = pDocument_->NewElement(type_tag_);
-      pType->SetAttribute(id_tag_, index++);
-      addPowerSetType(pType, set);
-      pTypesInfo->LinkEndChild(pType);
-    }
-
-    for (unsigned int id = sets_index; id < types.size(); id++)
+    for (unsigned int id = 0; id < types_.size(); id++)
     {
       XMLElement *pType = pDocument_->NewElement(type_tag_);
       pType->SetAttribute(id_tag_, id);
-      addType(pType, types[id]);
+      addType(pType, id);
       pTypesInfo->LinkEndChild(pType);
     }
 
     pDocument_->FirstChildElement()->LinkEndChild(pTypesInfo);
   }
 
-  void Writer::addType(XMLElement *pType, string type)
+  void Writer::addType(XMLElement *pType, int id)
   {
-    if (type.starts_with("(POW") and not sets_to_types_.contains(type))
+    const RichType &type = types_[id];
+    switch (type.kind)
+    {
+    case Kind::Set:
+      addSetType(pType, type.set);
+      break;
+    case Kind::PowerSet:
     {
       XMLElement *pPow = pDocument_->NewElement(power_set_tag_);
-      pPow->SetAttribute(arg_tag_, types_[getArgFromPow(type)]);
+      pPow->SetAttribute(arg_tag_, type.arg1);
       pType->LinkEndChild(pPow);
+      break;
     }
-    else if (type.starts_with("(PRODUCT"))
+    case Kind::Product:
     {
       XMLElement *pCartesianProduct = pDocument_->NewElement(product_tag_);
-      pair<string, string> args = getArgsFromCartesianProduct(type);
-      pCartesianProduct->SetAttribute(arg1_tag_, types_[args.first]);
-      pCartesianProduct->SetAttribute(arg2_tag_, types_[args.second]);
+      pCartesianProduct->SetAttribute(arg1_tag_, type.arg1);
+      pCartesianProduct->SetAttribute(arg2_tag_, type.arg2);
       pType->LinkEndChild(pCartesianProduct);
+      break;
     }
-    else
-    {
-      if (type[0] == '(' and type.back() == ')')
-      {
-        type.erase(0, 1);
-        type.pop_back();
-      }
+    case Kind::Identifier:
       // If it is an default identifier, we create a type
-      if (default_identifiers_.contains(type))
+      if (default_identifiers_.contains(type.name))
       {
-        XMLElement *pNewType = pDocument_->NewElement(type.c_str());
+        XMLElement *pNewType = pDocument_->NewElement(type.name.c_str());
         pType->LinkEndChild(pNewType);
       }
       // Else, it is a set and we look for (POW id)
       else
       {
         XMLElement *pNewType = pDocument_->NewElement(power_set_tag_);
-        pNewType->SetAttribute(arg_tag_, types_[type]);
+        pNewType->SetAttribute(arg_tag_, id);
         pType->LinkEndChild(pNewType);
       }
+      break;
     }
   }
 
@@ -270,49 +269,4 @@ namespace genericwriter
     }
   }
 
-  void Writer::addPowerSetType(tinyxml2::XMLElement *pType, Set::shared_ptr set)
-  {
-    string str_set = set->getID()->format();
-    XMLElement *pPow = pDocument_->NewElement(power_set_tag_);
-    pPow->SetAttribute(arg_tag_, types_[str_set]);
-    pType->LinkEndChild(pPow);
-  }
-
-  string Writer::getArgFromPow(const string &pow)
-  {
-    string copy = pow;
-    copy.erase(0, 5);
-    copy.pop_back();
-    return copy;
-  }
-
-  pair<string, string> Writer::getArgsFromCartesianProduct(const string &product)
-  {
-    string copy = product;
-    copy.erase(0, 9);
-    copy.pop_back();
-    string arg1, arg2;
-    int opening_parenthesis = 0;
-    int arg2_pos = 0;
-    for (auto character : copy)
-    {
-      arg2_pos++;
-      if (character == '(')
-        opening_parenthesis++;
-      if (character == ')')
-        opening_parenthesis--;
-      if (opening_parenthesis == 0)
-        break;
-      arg1 += character;
-    }
-    if (arg1 == "")
-    {
-      arg2_pos = copy.find_first_of(' ');
-    }
-    arg1 = copy.substr(0, arg2_pos);
-    // The +1 is to remove the space between the args
-    arg2 = copy.substr(arg2_pos + 1, copy.size());
-    return {arg1, arg2};
-  }
-
 } // namespace genericwriter
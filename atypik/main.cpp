@@ -11,7 +11,9 @@
 #include "machinetypes.h"
 #include "modelset.h"
 #include "pogparser.h"
+#include "session.h"
 #include "solverfactory.h"
+#include "threadpool.h"
 #include "timemanager.h"
 #include "writer.h"
 
@@ -38,6 +40,31 @@ void displayHelp(string prog)
        << endl;
   cout << "--disable-multi-thread \t disable multi threading for pog files."
        << endl;
+  cout << "--incremental \t solve the proof obligations of pog files "
+          "incrementally, sharing the Define constraints in one solver per "
+          "thread."
+       << endl;
+  cout << "--seed-defines \t solve the Define constraints of pog files once "
+          "and solve each proof obligation with the resulting types."
+       << endl;
+  cout << "--jobs \t <n> the number of threads used to solve the models. The "
+          "number of hardware threads is used by default."
+       << endl;
+  cout << "--batch-cost \t <n> the cost up to which small independent models "
+          "are solved by a single solver call, 0 to disable it. The default "
+          "is 256, or 0 if a solver limit is given."
+       << endl;
+  cout << "--cache \t reuse the types of the models already solved by a "
+          "previous run, stored in the ~/.cache/atypik directory."
+       << endl;
+  cout << "--time-limit \t <ms> the time limit of the solver for each model. "
+          "The models exceeding it are reported and left untyped. The models "
+          "are not batched unless --batch-cost is given."
+       << endl;
+  cout << "--resource-limit \t <n> the resource limit of the solver for each "
+          "model. The models exceeding it are reported and left untyped. The "
+          "models are not batched unless --batch-cost is given."
+       << endl;
   cout << "--abstraction \t for pog files generated from abstract machines"
        << endl;
   cout << "--implementation \t for pog files generated from implementations"
@@ -47,7 +74,8 @@ void displayHelp(string prog)
 
 void solve(genericparser::Parser::unique_ptr parser,
            genericwriter::Writer::unique_ptr writer, string input,
-           string output, bool disable_multi_thread, bool verbose)
+           string output, bool disable_multi_thread, bool incremental,
+           bool seed_defines, bool verbose)
 {
   Chrono chrono;
   chrono.start();
@@ -56,6 +84,10 @@ void solve(genericparser::Parser::unique_ptr parser,
   XMLDocument *pDoc = doc.ToDocument();
   if (disable_multi_thread)
     parser->disableMultiThread();
+  if (incremental)
+    parser->enableIncrementalSolving();
+  if (seed_defines)
+    parser->enableDefinesSeeding();
   Context::shared_ptr context = parser->parse(pDoc);
   if (verbose)
     chrono.displayElapsedTime(TimeUnit::Seconds, "Parsing time : ");
@@ -63,20 +95,42 @@ void solve(genericparser::Parser::unique_ptr parser,
   const unordered_set<Expression::shared_ptr> expressions =
       context->getExpressions();
   chrono.reset();
-  unordered_map<Variable::shared_ptr, string> var_to_type;
+  Solution var_to_type;
 
   try
   {
-    ModelSet modelset = ModelSet(models);
+    Model::shared_ptr base = context->getBaseModel();
+    ModelSet::Strategy strategy = seed_defines ? ModelSet::Strategy::Seeded
+                                               : ModelSet::Strategy::Incremental;
+    ModelSet modelset =
+        base != nullptr ? ModelSet(base, models, strategy) : ModelSet(models);
     var_to_type = modelset.solve();
+    for (auto &exceeded : modelset.getExceeded())
+      cerr << "Warning: " << exceeded.what()
+           << ". Its expressions are not typed." << endl;
   }
   catch (SolverError e)
   {
-    unordered_map<string, string> terms;
-    for (auto expr : expressions)
-      terms[expr->getAssociatedVariable()->toSMT()] =
-          "t(" + expr->format() + ")";
-    e.replaceTerms(terms);
+    // Only the expressions of the variables of the unsolved constraints are
+    // looked up and formatted
+    set<int> ids = e.getVariableIds();
+    unordered_map<int, Expression::shared_ptr> id_to_expression;
+    for (auto &&expr : expressions)
+    {
+      if (id_to_expression.size() == ids.size())
+        break;
+      int id = expr->getAssociatedVariable()->getNumericId();
+      if (ids.contains(id))
+        id_to_expression.emplace(id, expr);
+    }
+    e.describeVariables(
+        [&id_to_expression](int id)
+        {
+          auto expr = id_to_expression.find(id);
+          if (expr == id_to_expression.end())
+            return string();
+          return "t(" + expr->second->format() + ")";
+        });
     throw e;
   }
   if (verbose)
@@ -100,13 +154,13 @@ void solve(genericparser::Parser::unique_ptr parser,
   // for (auto expression : expressions)
   // {
   //   Variable::shared_ptr var = expression->getAssociatedVariable();
-  //   string type = var_to_type[var];
+  //   string type = var_to_type.get(var)->toSMT();
   //   cout << expression->format() << " : " << type << endl;
   // }
   // for (auto operation : context->getOperations())
   // {
   //   Variable::shared_ptr var = operation->getAssociatedVariable();
-  //   string type = var_to_type[var];
+  //   string type = var_to_type.get(var)->toSMT();
   //   cout << operation->format() << " : " << type << endl;
   // }
 }
@@ -121,10 +175,20 @@ int main(int argc, char **argv)
       {"help", no_argument, nullptr, 'h'},
       {"verbose", no_argument, nullptr, 'v'},
       {"disable-multi-thread", no_argument, nullptr, 'd'},
+      {"incremental", no_argument, nullptr, 'n'},
+      {"seed-defines", no_argument, nullptr, 's'},
+      {"jobs", required_argument, nullptr, 'j'},
+      {"batch-cost", required_argument, nullptr, 'c'},
+      {"cache", no_argument, nullptr, 'k'},
+      {"time-limit", required_argument, nullptr, 't'},
+      {"resource-limit", required_argument, nullptr, 'r'},
       {"abstraction", no_argument, nullptr, 'a'},
       {"implementation", no_argument, nullptr, 'i'},
       {nullptr, no_argument, nullptr, 0}};
 
+  // The variables, constraints and solvers of the run belong to its session
+  Session::shared_ptr session = make_shared<Session>();
+  Session::Scope session_scope(session);
   bxml::Parser::unique_ptr bxml_parser;
   pog::Parser::unique_ptr pog_parser;
   Writer::unique_ptr writer = make_unique<Writer>();
@@ -134,6 +198,12 @@ int main(int argc, char **argv)
   bool pog = false, bxml = false;
   bool verbose = false;
   bool disable_multi_thread = false;
+  bool incremental = false;
+  bool seed_defines = false;
+  int jobs = 0;
+  // Negative while the batch cost is not given
+  int batch_cost = -1;
+  unsigned int time_limit = 0, resource_limit = 0;
   genericparser::MachineType machine_type =
       genericparser::MachineType::Undefined;
   while ((opt = getopt_long(argc, argv, short_opts, long_opts, nullptr)) !=
@@ -168,6 +238,73 @@ int main(int argc, char **argv)
     case 'd':
       disable_multi_thread = true;
       break;
+    case 'n':
+      incremental = true;
+      break;
+    case 's':
+      seed_defines = true;
+      break;
+    case 'j':
+      try
+      {
+        jobs = std::stoi(optarg);
+      }
+      catch (std::exception &e)
+      {
+        jobs = 0;
+      }
+      if (jobs <= 0)
+      {
+        cerr << "The number of jobs must be a positive integer" << endl;
+        exit(1);
+      }
+      ThreadPool::setSharedSize(jobs);
+      break;
+    case 'c':
+      try
+      {
+        batch_cost = std::stoi(optarg);
+      }
+      catch (std::exception &e)
+      {
+        batch_cost = -1;
+      }
+      if (batch_cost < 0)
+      {
+        cerr << "The batch cost must be a non-negative integer" << endl;
+        exit(1);
+      }
+      session->setBatchCost(batch_cost);
+      break;
+    case 'k':
+      session->setCache(
+          make_shared<ModelCache>(ModelCache::getDefaultDirectory()));
+      break;
+    case 't':
+    case 'r':
+    {
+      int limit;
+      try
+      {
+        limit = std::stoi(optarg);
+      }
+      catch (std::exception &e)
+      {
+        limit = -1;
+      }
+      if (limit < 0)
+      {
+        cerr << "The solver limits must be non-negative integers" << endl;
+        exit(1);
+      }
+      if (opt == 't')
+        time_limit = limit;
+      else
+        resource_limit = limit;
+      session->getSolverPool().setLimits(time_limit,
+                                         resource_limit);
+      break;
+    }
     case 'a':
       machine_type = genericparser::MachineType::Abstraction;
       break;
@@ -182,6 +319,11 @@ int main(int argc, char **argv)
     }
   }
 
+  // The limits of the solver apply to each model, so the models are not
+  // batched unless asked for
+  if (batch_cost < 0 and (time_limit > 0 or resource_limit > 0))
+    session->setBatchCost(0);
+
   if (not bxml and not pog)
   {
     cerr << "The file to parse must be bxml or pog format" << endl;
@@ -222,12 +364,22 @@ int main(int argc, char **argv)
       cerr << "Multi threading is only available for pog files" << endl;
       exit(1);
     }
+    if (incremental)
+    {
+      cerr << "Incremental solving is only available for pog files" << endl;
+      exit(1);
+    }
+    if (seed_defines)
+    {
+      cerr << "Defines seeding is only available for pog files" << endl;
+      exit(1);
+    }
 
     for (unsigned int i = optind + 1; i < argc; i++)
       bxml_folders.emplace_back(argv[i]);
     bxml_parser->addFolders(bxml_folders);
     solve(move(bxml_parser), move(writer), input, output, disable_multi_thread,
-          verbose);
+          incremental, seed_defines, verbose);
   }
   if (pog)
   {
@@ -236,9 +388,26 @@ int main(int argc, char **argv)
       cerr << "Machine type has to be given." << endl;
       exit(1);
     }
+    if (incremental and disable_multi_thread)
+    {
+      cerr << "Incremental solving needs multi threading" << endl;
+      exit(1);
+    }
+    if (seed_defines and disable_multi_thread)
+    {
+      cerr << "Defines seeding needs multi threading" << endl;
+      exit(1);
+    }
+    if (seed_defines and incremental)
+    {
+      cerr << "Defines seeding and incremental solving cannot be used at the "
+              "same time"
+           << endl;
+      exit(1);
+    }
     pog_parser->setMachineType(machine_type);
     solve(move(pog_parser), move(writer), input, output, disable_multi_thread,
-          verbose);
+          incremental, seed_defines, verbose);
   }
 
   return 0;
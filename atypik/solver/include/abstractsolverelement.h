@@ -28,6 +28,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 
 namespace smt {
 class AbsTerm;
@@ -70,11 +71,90 @@ public:
     virtual std::set<int> getVariables() = 0;
 };
 
+class AbstractTerm;
+
+/*!
+ * \brief The TermCache class stores the terms created in a solver, so that
+ * each solver element is translated once per solver. The cache keeps the
+ * elements alive, so that the address of an element is not reused by another
+ * element while its term is cached.
+ */
+class TermCache
+{
+public:
+    /*!
+     * \brief Get the term created for an element
+     * \param element
+     * The element
+     * \return the term, or nullptr if none is created yet
+     */
+    smt::Term find(const AbstractTerm *element) const;
+    /*!
+     * \brief Store the term created for an element
+     * \param element
+     * The element, which must be owned by a shared pointer
+     * \param term
+     * The term
+     * \return the term
+     */
+    const smt::Term &add(AbstractTerm *element, smt::Term term);
+    /*!
+     * \brief The symbols of the declared variables indexed by their numeric
+     * id. The terms using other variables are not built.
+     */
+    std::unordered_map<int, smt::Term> symbols;
+    /*!
+     * \brief Get a constructor of a sort, looking it up only once by name
+     * \param solver
+     * The solver
+     * \param sort
+     * The sort
+     * \param name
+     * The name of the constructor
+     * \return the constructor
+     */
+    smt::Term getConstructor(smt::SmtSolver solver, smt::Sort sort,
+                             const std::string &name);
+
+private:
+    /*!
+     * \brief A hash of the elements on their address, accepting raw pointers
+     * so that an element is looked up without copying a shared pointer
+     */
+    struct Hash {
+        using is_transparent = void;
+        size_t operator()(const AbstractTerm *element) const;
+        size_t operator()(const std::shared_ptr<AbstractTerm> &element) const;
+    };
+    /*!
+     * \brief An equality of the elements on their address
+     */
+    struct Equal {
+        using is_transparent = void;
+        bool operator()(const std::shared_ptr<AbstractTerm> &left,
+                        const std::shared_ptr<AbstractTerm> &right) const;
+        bool operator()(const AbstractTerm *left,
+                        const std::shared_ptr<AbstractTerm> &right) const;
+        bool operator()(const std::shared_ptr<AbstractTerm> &left,
+                        const AbstractTerm *right) const;
+    };
+    /*!
+     * \brief The terms created for the elements
+     */
+    std::unordered_map<std::shared_ptr<AbstractTerm>, smt::Term, Hash, Equal>
+        terms_;
+    /*!
+     * \brief The constructors already looked up associated to their name
+     */
+    std::unordered_map<std::string, smt::Term> constructors_;
+};
+
 /*!
  * \brief The AbstractTerm class represents a solver element which can be used as a
  * Term
  */
-class AbstractTerm : public AbstractSolverElement {
+class AbstractTerm : public AbstractSolverElement,
+                     public std::enable_shared_from_this<AbstractTerm> {
 public:
     /*!
      * \brief Create a term from a solver corresponding to the type
@@ -82,9 +162,12 @@ public:
      * The solver
      * \param sort
      * The sort
+     * \param cache
+     * The terms already created in the solver, reused for the subterms
      * \return the created term
      */
-    virtual smt::Term getTerm(smt::SmtSolver solver, smt::Sort sort) = 0;
+    virtual smt::Term getTerm(smt::SmtSolver solver, smt::Sort sort,
+                              TermCache &cache) = 0;
     /*!
      * \brief A shared pointer on an abstract term
      */
@@ -28,8 +28,56 @@
 #include "abstractsolverelement.h"
 #include "constraint.h"
 
+#include <string_view>
+#include <vector>
+
 namespace solver
 {
+/*!
+ * \brief The Provenance class describes the element of the parsed file from
+ * which an assertion was generated. It only records names with a static
+ * storage duration and the position of the element, the description being
+ * built when an error is displayed
+ */
+class Provenance
+{
+public:
+    /*!
+     * \brief Construct an unknown provenance
+     */
+    Provenance() = default;
+    /*!
+     * \brief Construct a provenance
+     * \param origin
+     * The name of the originating element, with a static storage duration
+     * \param op
+     * The operator of the element, with a static storage duration, empty if
+     * none
+     * \param line
+     * The line of the element, -1 if unknown
+     * \param column
+     * The column of the element, -1 if unknown
+     */
+    Provenance(std::string_view origin, std::string_view op, int line,
+               int column);
+    /*!
+     * \brief Check whether the originating element is known
+     * \return true if the provenance has an origin
+     */
+    bool isKnown() const;
+    /*!
+     * \brief Describe the provenance
+     * \return a description of the originating element and of its position
+     */
+    std::string toString() const;
+
+private:
+    std::string_view origin_;
+    std::string_view op_;
+    int line_ = -1;
+    int column_ = -1;
+};
+
 class Assertion : public AbstractSolverElement
 {
 public:
@@ -37,8 +85,11 @@ public:
      * \brief Construct an assertion on a constraint
      * \param constraint
      * The constraint
+     * \param provenance
+     * The element from which the assertion was generated, if known
      */
-    Assertion(AbstractConstraint::shared_ptr constraint);
+    Assertion(AbstractConstraint::shared_ptr constraint,
+              Provenance provenance = Provenance());
     /*!
      * \brief A shared pointer on an Assertion
      */
@@ -51,12 +102,46 @@ public:
      * \return the constraint
      */
     AbstractConstraint::shared_ptr getConstraint();
+    /*!
+     * \brief An accessor on the provenance
+     * \return the provenance of the assertion
+     */
+    const Provenance &getProvenance() const;
+    /*!
+     * \brief Check if the constraint is an equality between B types, which can
+     * be solved by unification
+     * \return true if the constraint can be unified, false otherwise
+     */
+    bool isUnifiable() const;
+    /*!
+     * \brief An accessor on the variables of the constraint, computed once
+     * when the assertion is constructed
+     * \return the sorted numeric ids of the variables
+     */
+    const std::vector<int> &getVariableIds() const;
+    /*!
+     * \brief Compute again the variables of the constraint, after they are
+     * renumbered
+     */
+    void updateVariableIds();
 
 private:
     /*!
      * \brief The constraint on which the assertion is done
      */
     AbstractConstraint::shared_ptr constraint_;
+    /*!
+     * \brief The element from which the assertion was generated
+     */
+    Provenance provenance_;
+    /*!
+     * \brief The sorted numeric ids of the variables of the constraint
+     */
+    std::vector<int> variable_ids_;
+    /*!
+     * \brief Whether the constraint is an equality between B types
+     */
+    bool unifiable_;
 };
 }
 
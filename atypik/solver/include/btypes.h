@@ -57,7 +57,8 @@ public:
      */
     BIdent(std::string id);
     std::string toSMT() override;
-    smt::Term getTerm(smt::SmtSolver solver, smt::Sort sort) override;
+    smt::Term getTerm(smt::SmtSolver solver, smt::Sort sort,
+                      TermCache &cache) override;
     /*!
      * \brief A shared_ptr on a BIdent
      */
@@ -85,7 +86,8 @@ public:
     BCartesianProduct(AbstractBType::shared_ptr left,
                       AbstractBType::shared_ptr right);
     std::string toSMT() override;
-    smt::Term getTerm(smt::SmtSolver solver, smt::Sort sort) override;
+    smt::Term getTerm(smt::SmtSolver solver, smt::Sort sort,
+                      TermCache &cache) override;
     bool contains(AbstractSolverElement::shared_ptr var) override;
     std::string toString() override;
     std::set<int> getVariables() override;
@@ -125,7 +127,8 @@ public:
      */
     BPow(AbstractBType::shared_ptr type);
     std::string toSMT() override;
-    smt::Term getTerm(smt::SmtSolver solver, smt::Sort sort) override;
+    smt::Term getTerm(smt::SmtSolver solver, smt::Sort sort,
+                      TermCache &cache) override;
     bool contains(AbstractSolverElement::shared_ptr var) override;
     std::string toString() override;
     std::set<int> getVariables() override;
@@ -150,12 +153,13 @@ class Variable : public AbstractBType
 {
 public:
     /*!
-     * \brief Construct a variable from an identifier
-     * \param id
+     * \brief Construct a variable numbered in the session of the current
+     * thread. Its name is derived from its numeric id.
      */
-    Variable(std::string id);
+    Variable();
     std::string toSMT() override;
-    smt::Term getTerm(smt::SmtSolver solver, smt::Sort sort) override;
+    smt::Term getTerm(smt::SmtSolver solver, smt::Sort sort,
+                      TermCache &cache) override;
     bool contains(AbstractSolverElement::shared_ptr var) override;
     std::string toString() override;
     std::set<int> getVariables() override;
@@ -175,18 +179,11 @@ public:
     int getNumericId();
 
 private:
-    /*!
-     * \brief The type id
-     */
-    std::string id_;
+    friend class VarGenerator;
     /*!
      * \brief The unique numeric id of the variable
      */
     int numeric_id_;
-    /*!
-     * \brief A counter on the occurences of variables
-     */
-    int static cpt_;
 };
 }
 
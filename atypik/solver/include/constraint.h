@@ -28,6 +28,7 @@
 #include "abstractsolverelement.h"
 #include "btypes.h"
 
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -52,10 +53,6 @@ private:
      * \brief The id of the assertion
      */
     std::string id_;
-    /*!
-     * \brief A counter representing the number of assertions generated
-     */
-    static unsigned int cpt_;
 };
 
 class Equals : public AbstractConstraint
@@ -77,8 +74,19 @@ public:
     std::string toSMT() override;
     bool contains(AbstractSolverElement::shared_ptr var) override;
     std::set<int> getVariables() override;
-    smt::Term getTerm(smt::SmtSolver solver, smt::Sort sort) override;
+    smt::Term getTerm(smt::SmtSolver solver, smt::Sort sort,
+                      TermCache &cache) override;
     std::string toString() override;
+    /*!
+     * \brief An accessor on the left member of the constraint
+     * \return the left member of the constraint
+     */
+    AbstractTerm::shared_ptr getLeft();
+    /*!
+     * \brief An accessor on the right member of the constraint
+     * \return the right member of the constraint
+     */
+    AbstractTerm::shared_ptr getRight();
 
 private:
     /*!
@@ -110,8 +118,19 @@ public:
     std::string toSMT() override;
     bool contains(AbstractSolverElement::shared_ptr var) override;
     std::set<int> getVariables() override;
-    smt::Term getTerm(smt::SmtSolver solver, smt::Sort sort) override;
+    smt::Term getTerm(smt::SmtSolver solver, smt::Sort sort,
+                      TermCache &cache) override;
     std::string toString() override;
+    /*!
+     * \brief An accessor on the left member of the conjunction
+     * \return the left member
+     */
+    AbstractTerm::shared_ptr getLeft();
+    /*!
+     * \brief An accessor on the right member of the conjunction
+     * \return the right member
+     */
+    AbstractTerm::shared_ptr getRight();
 
 private:
     /*!
@@ -139,8 +158,14 @@ public:
     std::string toSMT() override;
     bool contains(AbstractSolverElement::shared_ptr var) override;
     std::set<int> getVariables() override;
-    smt::Term getTerm(smt::SmtSolver solver, smt::Sort sort) override;
+    smt::Term getTerm(smt::SmtSolver solver, smt::Sort sort,
+                      TermCache &cache) override;
     std::string toString() override;
+    /*!
+     * \brief An accessor on the negated term
+     * \return the negated term
+     */
+    AbstractTerm::shared_ptr getOperand();
 
 
 private:
@@ -149,6 +174,20 @@ private:
      */
     AbstractTerm::shared_ptr term_;
 };
+
+/*!
+ * \brief Write a term in the SMT syntax, an equality being written as
+ * left = right, with a custom name for its variables
+ * \param term
+ * The term
+ * \param describe
+ * A function giving the name of a variable from its numeric id, or an empty
+ * string to keep the variable name. It is called in the order in which the
+ * variables appear in the term.
+ * \return the term
+ */
+std::string formatTerm(AbstractTerm::shared_ptr term,
+                       const std::function<std::string(int)> &describe);
 }
 
 #endif // CONSTRAINT_H
@@ -0,0 +1,119 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#ifndef CONSTRAINTSTORE_H
+#define CONSTRAINTSTORE_H
+
+#include <span>
+#include <vector>
+
+#include "assertion.h"
+
+namespace solver
+{
+/*!
+ * \brief The ConstraintStore class holds the assertions of a model in a
+ * contiguous array of pointers filled by appending. It is not a struct of
+ * arrays: the kind, the variables and the provenance of each constraint stay
+ * in its assertion, which the factory shares between the models, and the
+ * solvers still translate the constraint trees. The duplicates are removed
+ * when the assertions are about to be solved or split, instead of being looked
+ * up at each addition.
+ */
+class ConstraintStore
+{
+public:
+    /*!
+     * \brief Append an assertion
+     * \param assertion
+     * The assertion
+     */
+    void add(Assertion::shared_ptr assertion);
+    /*!
+     * \brief Append the assertions of another store
+     * \param store
+     * The store
+     */
+    void add(const ConstraintStore &store);
+    /*!
+     * \brief Append an assertion of another store
+     * \param store
+     * The store
+     * \param index
+     * The index of the assertion in the store
+     */
+    void add(const ConstraintStore &store, size_t index);
+    /*!
+     * \brief Remove the assertions appended more than once, keeping the order
+     * of their first addition
+     */
+    void removeDuplicates();
+    /*!
+     * \brief An accessor on the number of assertions
+     * \return the number of assertions, including the duplicates which are
+     * not removed yet
+     */
+    size_t size() const;
+    /*!
+     * \brief Check if the store contains no assertion
+     * \return true if the store is empty, false otherwise
+     */
+    bool empty() const;
+    /*!
+     * \brief An accessor on the assertions in the order of their addition
+     * \return the assertions
+     */
+    const std::vector<Assertion::shared_ptr> &getAssertions() const;
+    /*!
+     * \brief An accessor on the variables of an assertion
+     * \param index
+     * The index of the assertion
+     * \return the sorted numeric ids of the variables of the assertion
+     */
+    std::span<const int> getVariables(size_t index) const;
+    /*!
+     * \brief Check if all the constraints are equalities between B types, in
+     * which case they can be solved by unification
+     * \return true if the constraints can be unified, false otherwise
+     */
+    bool isUnifiable() const;
+
+private:
+    /*!
+     * \brief The assertions in the order of their addition
+     */
+    std::vector<Assertion::shared_ptr> assertions_;
+    /*!
+     * \brief The number of constraints which are not equalities between B
+     * types
+     */
+    size_t not_unifiable_ = 0;
+    /*!
+     * \brief Whether the store is known to contain no duplicate
+     */
+    bool unique_ = true;
+};
+}
+
+#endif // CONSTRAINTSTORE_H
@@ -25,22 +25,14 @@
 #ifndef ERROR_H
 #define ERROR_H
 
+#include <functional>
 #include <memory>
-#include <unordered_map>
-#include <unordered_set>
+#include <set>
+#include <string>
 #include <vector>
 
-namespace smt {
-class AbsSmtSolver;
-using SmtSolver = std::shared_ptr<AbsSmtSolver>;
-class AbsTerm;
-using Term = std::shared_ptr<AbsTerm>;
-class AbsSort;
-using Sort = std::shared_ptr<AbsSort>;
-class AbsDatatypeDecl;
-using DatatypeDecl = std::shared_ptr<AbsDatatypeDecl>;
-using UnorderedTermSet = std::unordered_set<Term>;
-}
+#include "assertion.h"
+#include "btypes.h"
 
 namespace solver {
 class SolverError : public std::exception
@@ -54,26 +46,74 @@ public:
     SolverError(std::string message);
     /*!
      * \brief Construct a solver error for an unsatisfiable model
-     * \param unsolved_terms
-     * The terms which canot be solved
+     * \param message
+     * The message preceding the unsolved assertions
+     * \param unsolved
+     * The assertions which cannot be solved together
+     */
+    SolverError(std::string message,
+                std::vector<Assertion::shared_ptr> unsolved);
+    /*!
+     * \brief Describe the variables of the error message. Only the variables
+     * of the unsolved assertions are looked up.
+     * \param describe
+     * A function giving the description of a variable from its numeric id, or
+     * an empty string to keep the variable name
      */
-    SolverError(smt::UnorderedTermSet unsolved_terms);
+    void describeVariables(const std::function<std::string(int)> &describe);
     /*!
-     * \brief Replace all the terms in the error message by the one associated to it
-     * \param a map associating a term to a new one
+     * \brief An accessor on the variables of the unsolved assertions
+     * \return the numeric ids of the variables
      */
-    void replaceTerms(std::unordered_map<std::string, std::string> terms);
+    std::set<int> getVariableIds() const;
     const char * what() const noexcept override;
 
 
 private:
+    /*!
+     * \brief Build the message from the header and the unsolved terms
+     */
+    void buildMessage(const std::function<std::string(int)> &describe);
     /*!
      * \brief The message to display
      */
     std::string message_;
+    /*!
+     * \brief The message preceding the unsolved terms
+     */
+    std::string header_;
+    /*!
+     * \brief The terms which cannot be solved
+     */
+    std::vector<AbstractTerm::shared_ptr> unsolved_;
+    /*!
+     * \brief The provenance of each unsolved term
+     */
+    std::vector<Provenance> provenances_;
 
 };
 
+class SolverLimitError : public std::exception
+{
+public:
+    /*!
+     * \brief Construct an error for a model whose solving exceeded the time or
+     * resource limits of the solver
+     * \param assertions
+     * The number of assertions of the model
+     * \param variables
+     * The number of variables of the model
+     */
+    SolverLimitError(size_t assertions, size_t variables);
+    const char * what() const noexcept override;
+
+private:
+    /*!
+     * \brief The message to display
+     */
+    std::string message_;
+};
+
 }
 
 #endif // ERROR_H
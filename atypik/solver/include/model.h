@@ -32,6 +32,10 @@
 #include "abstractsolverelement.h"
 #include "assertion.h"
 #include "btypes.h"
+#include "constraintstore.h"
+#include "error.h"
+#include "solution.h"
+#include "solverpool.h"
 
 namespace smt
 {
@@ -48,6 +52,8 @@ namespace smt
 
 namespace solver
 {
+  class Factory;
+  class Session;
 
   /*!
    * \brief The Model class represents a Model which contains
@@ -57,7 +63,7 @@ namespace solver
   {
   public:
     /*!
-     * \brief Construct an empty model
+     * \brief Construct an empty model in the session of the current thread
      */
     Model();
     /*!
@@ -87,43 +93,102 @@ namespace solver
     void add(BIdent::shared_ptr id);
     /*!
      * \brief Return a solution to the current model if it is sat.
-     * \return A map of shape variable -> type where variable is a variable of
-     * the model and type is the infered type. Raises a execption if the model
-     * is unsat.
+     * \return The types infered for the variables of the model. Raises a
+     * execption if the model is unsat.
      */
-    std::unordered_map<Variable::shared_ptr, std::string> solve();
+    Typing solve();
+    /*!
+     * \brief Solve models sharing the assertions of the current one with a
+     * single solver. The assertions of the current model are added once, then
+     * the assertions of each model are solved in their own scope. The data
+     * types of the models are added to the current model.
+     * \param models
+     * The models solved on top of the current one
+     * \param exceeded
+     * Filled with the errors of the models exceeding the limits of the
+     * solver, which are skipped
+     * \return The types of the variables of the current model, followed by
+     * the types of the variables of each given model. The variables of the
+     * current model are only read once. Raises an exception if one of the
+     * models is unsat.
+     */
+    Typing solveIncrementally(
+        const std::vector<Model::shared_ptr> &models,
+        std::vector<SolverLimitError> &exceeded);
     /*!
      * \brief Merge the variables and assertions of the current model with another one
      * \param model
      * The model which will be merged with the current one
      */
     void merge(Model::shared_ptr model);
-    /**
-     * @brief Replace all variables introduce by a let in a term by its value
-     *
-     * @param term
-     * The term containing a let
-     * @return The instanciated term
-     */
-    static std::string instanciateTerm(std::string &term);
-
-  private:
     /*!
-     * \brief The solver
+     * \brief Split the model into independent models. Two assertions belong
+     * to the same model if they are linked by their variables.
+     * \return the connected components of the model, each one containing the
+     * data types of the current model
      */
-    smt::SmtSolver solver_;
+    std::vector<Model::shared_ptr> split();
     /*!
-     * \brief The sort of the type type
+     * \brief Estimate the cost of solving the model
+     * \return the number of assertions and variables of the model
      */
-    smt::Sort type_sort_;
+    size_t getCost();
     /*!
-     * \brief The declaration of the types type in the solver
+     * \brief Pack small independent models together, so that they are solved
+     * by a single solver call. Two models using a same variable are not packed
+     * together, and the solution of the batches merged in order gives the
+     * solution of the models merged in order.
+     * \param models
+     * The models, usually the components of split models
+     * \param budget
+     * The cost above which a batch is not extended, 0 to disable the batching
+     * \param indexes
+     * Filled with the index of the batch of each model
+     * \return the batches
      */
-    smt::DatatypeDecl types_;
+    static std::vector<Model::shared_ptr> batch(
+        const std::vector<Model::shared_ptr> &models, size_t budget,
+        std::vector<size_t> &indexes);
     /*!
-     * \brief The terms of the model indexed by their name
+     * \brief Write the model independently of the names of its variables and
+     * of the order of its elements. Two models with the same canonical form
+     * have the same solution up to the renaming of their variables.
+     * \param variables
+     * Filled with the variables of the model in the order of their canonical
+     * names
+     * \return the canonical form of the model
      */
-    std::unordered_map<std::string, smt::Term> terms_;
+    std::string getCanonicalForm(std::vector<Variable::shared_ptr> &variables);
+    /*!
+     * \brief Build the models to solve instead of the given models merged
+     * with the current one, once the current model is solved. The variables
+     * of the current model whose type is ground are bound to their type,
+     * the other ones keep the assertions of their connected component.
+     * \param models
+     * The models sharing the assertions of the current one
+     * \param solution
+     * The solution of the current model
+     * \return for each model, a model containing its assertions and the
+     * bindings or assertions of the variables of the current model it uses
+     */
+    std::vector<Model::shared_ptr> seed(
+        const std::vector<Model::shared_ptr> &models,
+        const Solution &solution);
+
+  private:
+    /*!
+     * \brief The session lending the solvers of the model
+     */
+    std::shared_ptr<Session> session_;
+    /*!
+     * \brief The solver, borrowed while the model is solved
+     */
+    SolverInstance::shared_ptr instance_;
+    /*!
+     * \brief The terms created in the solver for the assertions and their
+     * subterms, and the symbols of the variables of the model
+     */
+    TermCache term_cache_;
     /*!
      * \brief The types of data in the model
      */
@@ -131,15 +196,11 @@ namespace solver
     /*!
      * \brief The assertions
      */
-    std::unordered_set<Assertion::shared_ptr> assertions_;
+    ConstraintStore assertions_;
     /*!
      * \brief The variables of the problem associated to their id
      */
     std::unordered_set<Variable::shared_ptr> variables_;
-    /*!
-     * \brief A boolean checking if the solver has been initialized
-     */
-    bool initialized_;
     /*!
      * \brief Compute a SMT declaration of the used data types
      * \return a SMT declaration of the used data types
@@ -168,17 +229,107 @@ namespace solver
      */
     std::string SMTOptions();
     /*!
-     * \brief Set the solver options
+     * \brief Borrow a solver declaring the data types of the model from the
+     * shared pool, and declare the variables of the model in it
+     */
+    void acquireSolver();
+    /*!
+     * \brief Give the borrowed solver back to the shared pool
+     */
+    void releaseSolver();
+    /*!
+     * \brief Declare in the solver the variables which are not declared yet
+     * \param variables
+     * The variables to declare
+     */
+    void addVariables(const std::unordered_set<Variable::shared_ptr> &variables);
+    /*!
+     * \brief Build the B type represented by a value of the solver by
+     * walking the value term
+     * \param value
+     * The value
+     * \param factory
+     * The factory creating the types
+     * \param types
+     * The types already built for the visited values
+     * \return the B type
+     */
+    AbstractBType::shared_ptr getType(
+        const smt::Term &value, Factory &factory,
+        std::unordered_map<smt::Term, AbstractBType::shared_ptr> &types);
+    /*!
+     * \brief Build the solver terms of the assertions. As for the SMT solver,
+     * the assertions using undeclared terms are ignored.
+     * \param assertions
+     * The assertions
+     * \return the terms of the assertions
+     */
+    smt::UnorderedTermSet getTerms(const ConstraintStore &assertions);
+    /*!
+     * \brief Find the assertions whose terms are in an unsat core
+     * \param unsolved
+     * The terms of the unsat core
+     * \param assertions
+     * The checked assertions
+     * \return the assertions of the core
+     */
+    std::vector<Assertion::shared_ptr> getCore(
+        const smt::UnorderedTermSet &unsolved,
+        const ConstraintStore &assertions);
+    /*!
+     * \brief Assert the given assertions in the current scope of the solver
+     * and return the value of the variables. Raises an exception explaining
+     * the failure if the assertions are unsat.
+     * \param assertions
+     * The assertions to check
+     * \param variables
+     * The variables whose value is returned
+     * \return The types of the variables
+     */
+    Typing check(
+        const ConstraintStore &assertions,
+        const std::unordered_set<Variable::shared_ptr> &variables);
+    /*!
+     * \brief Solve the given assertions together with the ones of the model
+     * again, in a new solver producing the unsat assumptions
+     * \param assertions
+     * The assertions which were checked
+     * \param variables
+     * The variables of the assertions
+     * \return the assertions of the unsat core
+     */
+    std::vector<Assertion::shared_ptr> explain(
+        const ConstraintStore &assertions,
+        const std::unordered_set<Variable::shared_ptr> &variables);
+    /*!
+     * \brief Check if the model only contains equalities between B types, in
+     * which case it can be solved by unification
+     * \return true if the model can be solved by unification, false otherwise
+     */
+    bool isUnificationProblem();
+    /*!
+     * \brief Solve the model by unification without instanciating a SMT solver
+     * \return The solution of the model. Raises an exception if the model is
+     * unsat.
      */
-    void setOptions();
+    Typing solveByUnification();
     /*!
-     * \brief Add the default datatypes to the solver
+     * \brief Check if a type does not depend on the generic type A, which is
+     * given to the types left unconstrained by the solver
+     * \param type
+     * The type
+     * \return true if the type is ground, false otherwise
      */
-    void addDataTypes();
+    static bool isGround(AbstractBType::shared_ptr type);
     /*!
-     * \brief Add the variables to the solver
+     * \brief Solve models sharing the assertions of the current one by
+     * unification, each model being unified in its own scope
+     * \param models
+     * The models solved on top of the current one
+     * \return The solution of the models. Raises an exception if one of the
+     * models is unsat.
      */
-    void addVariables();
+    Typing solveIncrementallyByUnification(const std::vector<Model::shared_ptr> &models);
   };
 } // namespace solver
 
@@ -0,0 +1,111 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#ifndef MODELCACHE_H
+#define MODELCACHE_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "btypes.h"
+#include "model.h"
+#include "solution.h"
+
+namespace solver
+{
+/*!
+ * \brief The ModelCache class stores the solutions of the models on disk, so
+ * that a model already solved by a previous run is not solved again. The
+ * solutions are indexed by a hash of the canonical form of the models.
+ */
+class ModelCache
+{
+public:
+    /*!
+     * \brief Construct a cache stored in a directory
+     * \param directory
+     * The directory, created if needed
+     */
+    ModelCache(std::string directory);
+    /*!
+     * \brief A shared pointer on a ModelCache
+     */
+    typedef std::shared_ptr<ModelCache> shared_ptr;
+    /*!
+     * \brief Look for the solution of a model
+     * \param model
+     * The model
+     * \param solution
+     * Filled with the solution of the model if it is found
+     * \return true if the solution was found, false otherwise
+     */
+    bool lookup(Model::shared_ptr model,
+                Typing &solution);
+    /*!
+     * \brief Store the solution of a model. The errors are ignored, the
+     * solution being only lost for the next runs.
+     * \param model
+     * The model
+     * \param solution
+     * The solution of the model
+     */
+    void store(Model::shared_ptr model,
+               const Typing &solution);
+    /*!
+     * \brief Compute the default directory of the cache, in the user cache
+     * directory
+     * \return the default directory
+     */
+    static std::string getDefaultDirectory();
+
+private:
+    /*!
+     * \brief The directory of the cache
+     */
+    std::string directory_;
+    /*!
+     * \brief Compute the path of the file storing the solution of a model
+     * \param canonical_form
+     * The canonical form of the model
+     * \return the path of the file
+     */
+    std::string getPath(const std::string &canonical_form);
+    /*!
+     * \brief Read a type written in the SMT syntax
+     * \param text
+     * The text containing the type
+     * \param position
+     * The position of the type in the text, moved after the type
+     * \param factory
+     * The factory creating the type
+     * \return the type, nullptr if the text is not a type
+     */
+    static AbstractBType::shared_ptr readType(const std::string &text,
+                                              size_t &position,
+                                              Factory &factory);
+};
+}
+
+#endif // MODELCACHE_H
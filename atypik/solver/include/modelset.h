@@ -27,6 +27,8 @@
 
 #include <vector>
 #include "model.h"
+#include "modelcache.h"
+#include "session.h"
 
 namespace solver {
 /*!
@@ -35,18 +37,47 @@ namespace solver {
 class ModelSet {
 public:
     /*!
-     * \brief Construct a model set from a vector of models
+     * \brief The ways of solving models sharing a base model
+     */
+    enum class Strategy {
+        /*!
+         * \brief The base model is asserted once in a solver per thread and
+         * each model is solved in its own scope
+         */
+        Incremental,
+        /*!
+         * \brief The base model is solved first, then each model is solved
+         * with the types found for the base variables it uses
+         */
+        Seeded
+    };
+    /*!
+     * \brief Construct a model set from a vector of models, solved in the
+     * session of the current thread
      * \param models
      * The vector of models
      */
     ModelSet(std::vector<Model::shared_ptr> models);
+    /*!
+     * \brief Construct a model set whose models share the assertions of a
+     * base model
+     * \param base
+     * The model shared by all the models
+     * \param models
+     * The vector of models
+     * \param strategy
+     * The way the models are solved on top of the base model
+     */
+    ModelSet(Model::shared_ptr base, std::vector<Model::shared_ptr> models,
+             Strategy strategy = Strategy::Incremental);
     /*!
      * \brief Return a solution to the models if they are sat.
-     * \return A map of shape variable -> type where variable is a variable of
-     * one of the model and type is the infered type. Raises a execption
-     * if one of the model is unsat.
+     * \return The solution typing the variables of the models with the
+     * infered types. Raises a execption
+     * if one of the model is unsat. The models exceeding the limits of the
+     * solver are skipped.
      */
-    std::unordered_map<Variable::shared_ptr, std::string> solve();
+    Solution solve();
     /*!
      * \brief An accessor on the model of number num
      * \param num
@@ -54,12 +85,56 @@ public:
      * \return the model of number num
      */
     Model::shared_ptr getModel(int num);
+    /*!
+     * \brief An accessor on the errors of the models which exceeded the
+     * limits of the solver during the last solve. These models are skipped,
+     * their variables are not typed.
+     * \return the errors
+     */
+    const std::vector<SolverLimitError> &getExceeded();
 
 private:
     /*!
      * \brief The models in the set
      */
     std::vector<Model::shared_ptr> models_;
+    /*!
+     * \brief The model shared by the models of the set, if any
+     */
+    Model::shared_ptr base_;
+    /*!
+     * \brief The way the models are solved on top of the base model
+     */
+    Strategy strategy_;
+    /*!
+     * \brief The errors of the models which exceeded the limits of the solver
+     */
+    std::vector<SolverLimitError> exceeded_;
+    /*!
+     * \brief The session in which the set was constructed, giving the settings
+     * of the solving and bound to the threads solving the models
+     */
+    Session::shared_ptr session_;
+    /*!
+     * \brief Solve models concurrently, each independent part of a model
+     * being solved on its own
+     * \param models
+     * The models
+     * \return The types of the variables of the models, in the order of the
+     * models
+     */
+    Typing solve(const std::vector<Model::shared_ptr> &models);
+    /*!
+     * \brief Solve the models on top of the base model, the models being
+     * distributed among the threads
+     * \return The types of the variables of the base model and of the models
+     */
+    Typing solveIncrementally();
+    /*!
+     * \brief Solve the base model, then the models seeded with its solution
+     * \return The types of the variables of the base model and of the models
+     */
+    Typing solveSeeded();
 };
 }
 
@@ -0,0 +1,167 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "arena.h"
+#include "modelcache.h"
+#include "solverpool.h"
+
+namespace solver
+{
+/*!
+ * \brief The Session class owns the state of a typing job: the counters
+ * numbering the variables and the constraints, the arena of the parsed
+ * elements, the solvers and the settings of the solving. Several sessions can type different components concurrently
+ * in one process. The elements are created in the session bound to the
+ * current thread by a Scope.
+ */
+class Session
+{
+public:
+    /*!
+     * \brief A shared pointer on a Session
+     */
+    typedef std::shared_ptr<Session> shared_ptr;
+    /*!
+     * \brief The Scope class binds a session to the current thread for its
+     * lifetime, the previously bound session being restored on destruction
+     */
+    class Scope
+    {
+    public:
+        /*!
+         * \brief Bind a session to the current thread
+         * \param session
+         * The session
+         */
+        Scope(Session::shared_ptr session);
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        /*!
+         * \brief The session bound before the scope
+         */
+        Session::shared_ptr previous_;
+    };
+    /*!
+     * \brief An accessor on the session bound to the current thread
+     * \return the session bound to the current thread, the default session if
+     * none is bound
+     */
+    static Session::shared_ptr getCurrent();
+    /*!
+     * \brief An accessor on the session used by the threads to which no
+     * session is bound
+     * \return the default session
+     */
+    static Session::shared_ptr getDefault();
+    /*!
+     * \brief Give a new numeric identifier to a variable
+     * \return the identifier
+     */
+    int nextVariableId();
+    /*!
+     * \brief Give a new identifier to a constraint
+     * \return the identifier
+     */
+    unsigned int nextConstraintId();
+    /*!
+     * \brief An accessor on the number of variables created in the session
+     * \return the number of variables, which is also the next identifier
+     */
+    int getVariableCount() const;
+    /*!
+     * \brief An accessor on the arena in which the elements parsed in the
+     * session are allocated
+     * \return the arena
+     */
+    tools::Arena::shared_ptr getArena() const;
+    /*!
+     * \brief An accessor on the solvers of the session
+     * \return the solver pool
+     */
+    SolverPool &getSolverPool();
+    /*!
+     * \brief Set the cost up to which the independent parts of the models
+     * are packed into a single solver call
+     * \param cost
+     * The cost, 0 to solve each independent part on its own
+     */
+    void setBatchCost(size_t cost);
+    /*!
+     * \brief An accessor on the cost up to which the independent parts of the
+     * models are packed together
+     * \return the cost
+     */
+    size_t getBatchCost() const;
+    /*!
+     * \brief Set the cache of the solutions of the models solved
+     * independently
+     * \param cache
+     * The cache, nullptr to solve every model
+     */
+    void setCache(ModelCache::shared_ptr cache);
+    /*!
+     * \brief An accessor on the cache of the solutions
+     * \return the cache, nullptr if none is used
+     */
+    ModelCache::shared_ptr getCache() const;
+
+private:
+    /*!
+     * \brief The counter of the variables
+     */
+    std::atomic<int> variables_ = 0;
+    /*!
+     * \brief The counter of the constraints
+     */
+    std::atomic<unsigned int> constraints_ = 0;
+    /*!
+     * \brief The arena of the parsed elements
+     */
+    tools::Arena::shared_ptr arena_ = std::make_shared<tools::Arena>();
+    /*!
+     * \brief The solvers of the session
+     */
+    SolverPool solver_pool_;
+    /*!
+     * \brief The cost up to which the independent parts are packed together
+     */
+    size_t batch_cost_ = 256;
+    /*!
+     * \brief The cache of the solutions, if any
+     */
+    ModelCache::shared_ptr cache_;
+};
+}
+
+#endif // SESSION_H
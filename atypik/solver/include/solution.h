@@ -0,0 +1,104 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#ifndef SOLUTION_H
+#define SOLUTION_H
+
+#include <utility>
+#include <vector>
+
+#include "btypes.h"
+
+namespace solver
+{
+/*!
+ * \brief The types found for some variables, as pairs of a numeric id and a
+ * type. The models and their independent parts are solved into such sparse
+ * lists, whose size only depends on their own variables.
+ */
+typedef std::vector<std::pair<int, AbstractBType::shared_ptr>> Typing;
+
+/*!
+ * \brief The Solution class associates types to variables. The types are
+ * stored in a dense table indexed by the numeric ids of the variables, which
+ * are consecutive in a session. It is only built for the final result, sized
+ * once from the number of variables of the session.
+ */
+class Solution
+{
+public:
+    /*!
+     * \brief Construct an empty solution
+     */
+    Solution() = default;
+    /*!
+     * \brief Construct a solution whose table covers the given number of ids
+     * \param size
+     * The number of ids, usually the number of variables of the session
+     */
+    explicit Solution(int size);
+    /*!
+     * \brief An accessor on the type of a variable
+     * \param id
+     * The numeric id of the variable
+     * \return the type of the variable, nullptr if it is not typed
+     */
+    AbstractBType::shared_ptr get(int id) const;
+    /*!
+     * \brief An accessor on the type of a variable
+     * \param variable
+     * The variable
+     * \return the type of the variable, nullptr if it is not typed
+     */
+    AbstractBType::shared_ptr get(Variable::shared_ptr variable) const;
+    /*!
+     * \brief Set the type of a variable, growing the table if needed
+     * \param id
+     * The numeric id of the variable
+     * \param type
+     * The type
+     */
+    void set(int id, AbstractBType::shared_ptr type);
+    /*!
+     * \brief Add the types of a sparse list. A variable which is already
+     * typed, or typed several times by the list, keeps its first type.
+     * \param typing
+     * The types
+     */
+    void add(const Typing &typing);
+    /*!
+     * \brief An accessor on the size of the table
+     * \return the id following the largest id of the table
+     */
+    int size() const;
+
+private:
+    /*!
+     * \brief The type of each id, nullptr if the id is not typed
+     */
+    std::vector<AbstractBType::shared_ptr> types_;
+};
+}
+
+#endif // SOLUTION_H
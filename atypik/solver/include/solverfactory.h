@@ -30,6 +30,8 @@
 #include "constraint.h"
 #include "model.h"
 
+#include <functional>
+#include <utility>
 #include <vector>
 
 namespace solver
@@ -50,6 +52,11 @@ private:
     std::string message_;
 };
 
+/*!
+ * \brief The Factory class creates the elements of the solver. The types and
+ * constraints are hash-consed: structurally equal terms created by a factory
+ * share the same node, so they can be compared by address.
+ */
 class Factory
 {
 public:
@@ -155,14 +162,42 @@ public:
      */
     Model::shared_ptr makeModel();
     /*!
-     * \brief Create a variable from an identifier
-     * \param id
-     * The identifier
+     * \brief Create a variable numbered in the session of the current thread
      * \return a shared pointer on the variable
      */
-    static Variable::shared_ptr makeVariable(std::string id);
+    static Variable::shared_ptr makeVariable();
+    /*!
+     * \brief Set the provenance given to the assertions created from now on
+     * \param provenance
+     * The provenance, unknown if the assertions do not come from a parsed
+     * element
+     */
+    void setProvenance(Provenance provenance);
+    /*!
+     * \brief An accessor on the provenance given to the new assertions
+     * \return the current provenance
+     */
+    Provenance getProvenance() const;
+    /*!
+     * \brief Compute again the variables of the assertions created by the
+     * factory, after their variables are renumbered
+     */
+    void updateAssertions();
 
 private:
+    /*!
+     * \brief A hash on a pair of nodes computed from their addresses, which
+     * identify the structure of the hash-consed nodes
+     */
+    template <class T>
+    struct PairHash {
+        size_t operator()(const std::pair<T, T> &pair) const
+        {
+            size_t left = std::hash<T>()(pair.first);
+            return left ^ (std::hash<T>()(pair.second) + 0x9e3779b9 +
+                           (left << 6) + (left >> 2));
+        }
+    };
     /*!
      * \brief A map storing all the identifiers already created by the factory to
      * avoid creating them again
@@ -173,11 +208,41 @@ private:
      * avoid creating them again
      */
     std::unordered_map<AbstractBType::shared_ptr, BPow::shared_ptr> power_sets_;
+    /*!
+     * \brief A map storing all the cartesian products already created by the
+     * factory to avoid creating them again
+     */
+    std::unordered_map<std::pair<AbstractBType::shared_ptr, AbstractBType::shared_ptr>,
+                       BCartesianProduct::shared_ptr,
+                       PairHash<AbstractBType::shared_ptr>> products_;
+    /*!
+     * \brief A map storing all the equalities already created by the factory
+     * to avoid creating them again
+     */
+    std::unordered_map<std::pair<AbstractTerm::shared_ptr, AbstractTerm::shared_ptr>,
+                       Equals::shared_ptr,
+                       PairHash<AbstractTerm::shared_ptr>> equalities_;
+    /*!
+     * \brief A map storing all the disjunctions already created by the factory
+     * to avoid creating them again
+     */
+    std::unordered_map<std::pair<AbstractTerm::shared_ptr, AbstractTerm::shared_ptr>,
+                       Or::shared_ptr,
+                       PairHash<AbstractTerm::shared_ptr>> disjunctions_;
+    /*!
+     * \brief A map storing all the negations already created by the factory to
+     * avoid creating them again
+     */
+    std::unordered_map<AbstractTerm::shared_ptr, Not::shared_ptr> negations_;
     /*!
      * \brief A map storing all the assertions already created by the factory to
      * avoid creating them again
      */
-    std::unordered_map<std::string, Assertion::shared_ptr> assertions_;
+    std::unordered_map<AbstractConstraint::shared_ptr, Assertion::shared_ptr> assertions_;
+    /*!
+     * \brief The provenance given to the new assertions
+     */
+    Provenance provenance_;
 };
 }
 
@@ -0,0 +1,151 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#ifndef SOLVERPOOL_H
+#define SOLVERPOOL_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "btypes.h"
+
+namespace smt
+{
+  class AbsDatatypeDecl;
+  using DatatypeDecl = std::shared_ptr<AbsDatatypeDecl>;
+}
+
+namespace solver
+{
+
+/*!
+ * \brief The SolverInstance struct gathers a solver and the declarations done
+ * in it. The declarations are kept when the assertions of the solver are reset.
+ */
+struct SolverInstance {
+    /*!
+     * \brief A shared pointer on a SolverInstance
+     */
+    typedef std::shared_ptr<SolverInstance> shared_ptr;
+    /*!
+     * \brief The solver
+     */
+    smt::SmtSolver solver;
+    /*!
+     * \brief The declaration of the types datatype
+     */
+    smt::DatatypeDecl types;
+    /*!
+     * \brief The sort of the types datatype
+     */
+    smt::Sort type_sort;
+    /*!
+     * \brief The symbols declared in the solver indexed by the numeric id of
+     * their variable
+     */
+    std::unordered_map<int, smt::Term> symbols;
+    /*!
+     * \brief The names of the data types declared in the solver, which
+     * identify the solvers that can be exchanged
+     */
+    std::string key;
+};
+
+/*!
+ * \brief The SolverPool class keeps the solvers whose assertions have been
+ * reset, so that the models with the same data types borrow them instead of
+ * creating and configuring a new solver
+ */
+class SolverPool
+{
+public:
+    /*!
+     * \brief Borrow a solver declaring the given data types, creating it if
+     * no such solver is idle
+     * \param datatypes
+     * The data types
+     * \return the solver
+     */
+    SolverInstance::shared_ptr acquire(const std::vector<BIdent::shared_ptr> &datatypes);
+    /*!
+     * \brief Give back a borrowed solver. Its assertions are reset, the
+     * solvers declaring too many symbols are dropped.
+     * \param instance
+     * The solver
+     */
+    void release(SolverInstance::shared_ptr instance);
+    /*!
+     * \brief Create a solver declaring the given data types
+     * \param datatypes
+     * The data types
+     * \param explain
+     * A boolean telling if the solver has to produce the unsat assumptions
+     * \return the solver
+     */
+    SolverInstance::shared_ptr make(const std::vector<BIdent::shared_ptr> &datatypes,
+                                    bool explain = false) const;
+    /*!
+     * \brief Set the limits of each check of the solvers created from now on.
+     * A check exceeding a limit gives an unknown result.
+     * \param time
+     * The time limit in milliseconds, 0 for no limit
+     * \param resources
+     * The resource limit in the unit of the solver, 0 for no limit
+     */
+    void setLimits(unsigned int time, unsigned int resources);
+
+private:
+    /*!
+     * \brief The number of symbols above which a solver is not kept
+     */
+    static const size_t max_symbols_ = 1 << 16;
+    /*!
+     * \brief The time limit of a check in milliseconds, 0 for no limit
+     */
+    unsigned int time_limit_ = 0;
+    /*!
+     * \brief The resource limit of a check, 0 for no limit
+     */
+    unsigned int resource_limit_ = 0;
+    /*!
+     * \brief The mutex protecting idle_
+     */
+    std::mutex mutex_;
+    /*!
+     * \brief The idle solvers indexed by their key
+     */
+    std::unordered_map<std::string, std::vector<SolverInstance::shared_ptr>> idle_;
+    /*!
+     * \brief Compute the key of the solvers declaring some data types
+     * \param datatypes
+     * The data types
+     * \return the sorted names of the data types without duplicates
+     */
+    static std::vector<std::string> getNames(const std::vector<BIdent::shared_ptr> &datatypes);
+};
+}
+
+#endif // SOLVERPOOL_H
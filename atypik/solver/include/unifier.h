@@ -0,0 +1,304 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#ifndef UNIFIER_H
+#define UNIFIER_H
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "assertion.h"
+#include "btypes.h"
+#include "constraint.h"
+#include "error.h"
+#include "solution.h"
+#include "solverfactory.h"
+
+namespace solver
+{
+/*!
+ * \brief The Unifier class solves a conjunction of equalities between B types
+ * by first-order unification. It is used instead of a SMT solver when a model
+ * only contains Equals constraints.
+ */
+class Unifier
+{
+public:
+    /*!
+     * \brief Construct a unifier on the data types of a model
+     * \param datatypes
+     * The data types declared in the model
+     */
+    Unifier(const std::vector<BIdent::shared_ptr> &datatypes);
+    /*!
+     * \brief Declare the variables of a model
+     * \param variables
+     * The variables to declare
+     */
+    void declare(const std::unordered_set<Variable::shared_ptr> &variables);
+    /*!
+     * \brief Unify the two members of an asserted equality. As with the SMT
+     * solver, equalities on undeclared variables or data types are ignored.
+     * Raises a SolverError giving the asserted equalities which cannot hold
+     * together if the members cannot be unified or if a type would be
+     * infinite.
+     * \param assertion
+     * The assertion of the equality
+     */
+    void add(Assertion::shared_ptr assertion);
+    /*!
+     * \brief Compute the type of the given variables. Variables which are
+     * not constrained are given the generic type A.
+     * \param variables
+     * The variables
+     * \return The types of the variables
+     */
+    Typing solve(const std::unordered_set<Variable::shared_ptr> &variables);
+    /*!
+     * \brief Open a new scope. The declarations and equalities added in the
+     * scope are removed by the matching call to pop.
+     */
+    void push();
+    /*!
+     * \brief Close the current scope, restoring the state of the unifier at
+     * the matching call to push
+     */
+    void pop();
+
+private:
+    enum class Kind { Variable, Ident, Pow, Product };
+    /*!
+     * \brief A node of the term graph
+     */
+    struct Node {
+        Kind kind;
+        std::string name;
+        int left;
+        int right;
+    };
+    /*!
+     * \brief The size of the trails when a scope is opened
+     */
+    struct Scope {
+        size_t nodes;
+        size_t writes;
+        size_t declared;
+        size_t terms;
+        size_t variables;
+        size_t idents;
+        size_t asserted;
+    };
+    /*!
+     * \brief An equality between two nodes to unify, and the reason why it
+     * holds: an asserted equality, or the equality of two constructors whose
+     * members are the nodes
+     */
+    struct Equation {
+        int left;
+        int right;
+        int assertion;
+        int left_constructor;
+        int right_constructor;
+    };
+    /*!
+     * \brief A modification of the union-find forest which can be undone
+     */
+    struct Write {
+        std::vector<int> *array;
+        int index;
+        int old_value;
+    };
+    /*!
+     * \brief The nodes of the term graph
+     */
+    std::vector<Node> nodes_;
+    /*!
+     * \brief The parent of each node in the union-find forest
+     */
+    std::vector<int> parent_;
+    /*!
+     * \brief The rank of each node in the union-find forest
+     */
+    std::vector<int> rank_;
+    /*!
+     * \brief The constructor node of each equivalence class, indexed by the
+     * representative of the class, or -1 if the class only contains variables
+     */
+    std::vector<int> schema_;
+    /*!
+     * \brief The parent of each node in the proof forest, or -1 for a root.
+     * Unlike the union-find forest, its edges link the two nodes of each
+     * equation that merged two classes, so the path between two nodes of a
+     * class gives the equations explaining their equality.
+     */
+    std::vector<int> proof_parent_;
+    /*!
+     * \brief The index in asserted_ of the equality labelling the edge of
+     * each node to its parent in the proof forest, or -1 if the edge comes
+     * from the equality of two constructors
+     */
+    std::vector<int> proof_assertion_;
+    /*!
+     * \brief The constructors whose equality labels the edge of each node to
+     * its parent in the proof forest
+     */
+    std::vector<int> proof_left_;
+    std::vector<int> proof_right_;
+    /*!
+     * \brief The assertions added, in their order of addition
+     */
+    std::vector<Assertion::shared_ptr> asserted_;
+    /*!
+     * \brief The numeric ids of the declared variables
+     */
+    std::unordered_set<int> declared_;
+    /*!
+     * \brief The declared data types
+     */
+    std::unordered_set<std::string> datatypes_;
+    /*!
+     * \brief The nodes already built for a solver element
+     */
+    std::unordered_map<AbstractSolverElement *, int> terms_;
+    /*!
+     * \brief The nodes of the variables associated to their numeric id
+     */
+    std::unordered_map<int, int> variable_nodes_;
+    /*!
+     * \brief The nodes of the identifiers associated to their name
+     */
+    std::unordered_map<std::string, int> ident_nodes_;
+    /*!
+     * \brief The factory creating the computed types
+     */
+    Factory factory_;
+    /*!
+     * \brief The open scopes
+     */
+    std::vector<Scope> scopes_;
+    /*!
+     * \brief The modifications of the forest done in the open scopes
+     */
+    std::vector<Write> writes_;
+    /*!
+     * \brief The keys added in the open scopes to declared_, terms_,
+     * variable_nodes_ and ident_nodes_
+     */
+    std::vector<int> new_declared_;
+    std::vector<AbstractSolverElement *> new_terms_;
+    std::vector<int> new_variables_;
+    std::vector<std::string> new_idents_;
+    /*!
+     * \brief Build the node representing a term
+     * \param term
+     * The term
+     * \return the index of the node, or -1 if the term uses an undeclared
+     * variable or data type
+     */
+    int makeNode(AbstractTerm::shared_ptr term);
+    /*!
+     * \brief Add a node to the term graph
+     * \return the index of the new node
+     */
+    int newNode(Kind kind, std::string name = "", int left = -1, int right = -1);
+    /*!
+     * \brief Modify the union-find forest, remembering the previous value if a
+     * scope is open
+     * \param array
+     * The modified array (parent_, rank_, schema_ or an array of the proof
+     * forest)
+     * \param index
+     * The modified index
+     * \param value
+     * The new value
+     */
+    void assign(std::vector<int> &array, int index, int value);
+    /*!
+     * \brief Find the representative of the class of a node
+     * \param node
+     * The node
+     * \return the representative of the class
+     */
+    int find(int node);
+    /*!
+     * \brief Add the edge of an equation to the proof forest. The tree of its
+     * left node is first rooted at this node.
+     * \param equation
+     * The equation, whose nodes are in different classes
+     */
+    void link(const Equation &equation);
+    /*!
+     * \brief Find the asserted equalities implying the equality of two nodes
+     * of a class
+     * \param left
+     * A node
+     * \param right
+     * Another node of the class
+     * \param core
+     * The indexes in asserted_ of the equalities found
+     */
+    void explain(int left, int right, std::set<int> &core);
+    /*!
+     * \brief Look for a path from the constructor of a class back to the class
+     * \param root
+     * The representative of the class
+     * \param constructor
+     * A constructor on the path
+     * \param path
+     * The members of the constructors on the path, each with the constructor
+     * of its class
+     * \param visited
+     * The representatives already visited
+     * \return true if the path reaches the class, in which case its type would
+     * be infinite
+     */
+    bool occurs(int root, int constructor,
+                std::vector<std::pair<int, int>> &path,
+                std::unordered_set<int> &visited);
+    /*!
+     * \brief Build the error of an unsatisfiable model
+     * \param message
+     * The message preceding the asserted equalities
+     * \param core
+     * The indexes in asserted_ of the equalities which cannot hold together
+     * \return the error
+     */
+    SolverError unsatisfiable(std::string message, const std::set<int> &core);
+    /*!
+     * \brief Compute the type of a class
+     * \param node
+     * A node of the class
+     * \param cache
+     * The types already computed for the visited representatives
+     * \return the type
+     */
+    AbstractBType::shared_ptr typeOf(
+        int node, std::unordered_map<int, AbstractBType::shared_ptr> &cache);
+};
+}
+
+#endif // UNIFIER_H
@@ -25,6 +25,8 @@
 #ifndef VARGEN_H
 #define VARGEN_H
 
+#include <vector>
+
 #include "solverfactory.h"
 
 namespace solver
@@ -36,16 +38,45 @@ class VarGenerator
 {
 public:
     /*!
-     * \brief Generate a unique variable
+     * \brief Generate a variable unique in the session of the current thread
      * \return the generated variable
      */
     static solver::Variable::shared_ptr getNewVariable();
-
-private:
     /*!
-     * \brief A counter representing the number of variables generated
+     * \brief Give again consecutive numeric ids to variables, in their order
+     * \param variables
+     * The variables, whose types must not be solved yet
+     * \param first
+     * The id of the first variable
+     * \return the id following the one of the last variable
      */
-    static int cpt_;
+    static int renumber(const std::vector<Variable::shared_ptr> &variables,
+                        int first);
+    /*!
+     * \brief The Record class collects the variables generated by the current
+     * thread for its lifetime, the previous record being restored on
+     * destruction
+     */
+    class Record
+    {
+    public:
+        /*!
+         * \brief Collect the variables generated by the current thread
+         * \param variables
+         * The vector to which the variables are appended in their order of
+         * generation
+         */
+        Record(std::vector<Variable::shared_ptr> &variables);
+        ~Record();
+        Record(const Record &) = delete;
+        Record &operator=(const Record &) = delete;
+
+    private:
+        /*!
+         * \brief The vector collecting the variables before the record
+         */
+        std::vector<Variable::shared_ptr> *previous_;
+    };
 };
 }
 #endif // VARGEN_H
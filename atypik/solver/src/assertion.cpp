@@ -24,12 +24,40 @@
  */
 #include "assertion.h"
 
+using std::dynamic_pointer_cast;
 using std::set;
 using std::string;
+using std::string_view;
+using std::to_string;
+using std::vector;
 
 namespace solver {
-Assertion::Assertion(AbstractConstraint::shared_ptr constraint)
-    : constraint_(constraint) {}
+Provenance::Provenance(string_view origin, string_view op, int line,
+                       int column)
+    : origin_(origin), op_(op), line_(line), column_(column) {}
+
+bool Provenance::isKnown() const { return not origin_.empty(); }
+
+string Provenance::toString() const {
+  string result(origin_);
+  if (not op_.empty()) result.append(" ").append(op_);
+  if (line_ < 0) return result;
+  return result + " at line " + to_string(line_) + ", column " +
+         to_string(column_);
+}
+
+Assertion::Assertion(AbstractConstraint::shared_ptr constraint,
+                     Provenance provenance)
+    : constraint_(constraint), provenance_(provenance) {
+  // The assertions are hash-consed by the factory, so the variables and the
+  // kind of a constraint are computed once for all the models using it
+  updateVariableIds();
+  Equals::shared_ptr equals = dynamic_pointer_cast<Equals>(constraint_);
+  unifiable_ =
+      equals != nullptr and
+      dynamic_pointer_cast<AbstractBType>(equals->getLeft()) != nullptr and
+      dynamic_pointer_cast<AbstractBType>(equals->getRight()) != nullptr;
+}
 
 string Assertion::toSMT() { return "(assert " + constraint_->toSMT() + ")"; }
 
@@ -37,6 +65,17 @@ AbstractConstraint::shared_ptr Assertion::getConstraint() {
   return constraint_;
 }
 
+const Provenance& Assertion::getProvenance() const { return provenance_; }
+
+bool Assertion::isUnifiable() const { return unifiable_; }
+
+const vector<int>& Assertion::getVariableIds() const { return variable_ids_; }
+
+void Assertion::updateVariableIds() {
+  set<int> ids = constraint_->getVariables();
+  variable_ids_.assign(ids.begin(), ids.end());
+}
+
 bool Assertion::contains(AbstractSolverElement::shared_ptr var) {
   return constraint_->contains(var);
 }
@@ -24,11 +24,16 @@
  */
 #include "btypes.h"
 
+#include "session.h"
 #include "smt.h"
 
 using namespace smt;
+using std::dynamic_pointer_cast;
+using std::move;
 using std::set;
+using std::shared_ptr;
 using std::string;
+using std::to_string;
 
 namespace solver {
 
@@ -36,15 +41,58 @@ namespace solver {
 
 set<int> AbstractBType::getVariables() { return {}; }
 
+// Implementation of the TermCache class
+
+Term TermCache::find(const AbstractTerm* element) const {
+  auto term = terms_.find(element);
+  return term != terms_.end() ? term->second : nullptr;
+}
+
+const Term& TermCache::add(AbstractTerm* element, Term term) {
+  // The cache holds the element, so its address identifies it while cached
+  return terms_.emplace(element->shared_from_this(), move(term)).first->second;
+}
+
+size_t TermCache::Hash::operator()(const AbstractTerm* element) const {
+  return std::hash<const AbstractTerm*>{}(element);
+}
+
+size_t TermCache::Hash::operator()(
+    const shared_ptr<AbstractTerm>& element) const {
+  return (*this)(element.get());
+}
+
+bool TermCache::Equal::operator()(const shared_ptr<AbstractTerm>& left,
+                                  const shared_ptr<AbstractTerm>& right) const {
+  return left == right;
+}
+
+bool TermCache::Equal::operator()(const AbstractTerm* left,
+                                  const shared_ptr<AbstractTerm>& right) const {
+  return left == right.get();
+}
+
+bool TermCache::Equal::operator()(const shared_ptr<AbstractTerm>& left,
+                                  const AbstractTerm* right) const {
+  return left.get() == right;
+}
+
+Term TermCache::getConstructor(SmtSolver solver, Sort sort,
+                               const string& name) {
+  if (constructors_.contains(name)) return constructors_[name];
+  return constructors_[name] = solver->get_constructor(sort, name);
+}
+
 // Implementation of the BIdent class
 
 BIdent::BIdent(string id) : id_(id) {}
 
 string BIdent::toSMT() { return id_; }
 
-Term BIdent::getTerm(SmtSolver solver, Sort sort) {
-  Term ident = solver->get_constructor(sort, id_);
-  return solver->make_term(Apply_Constructor, ident);
+Term BIdent::getTerm(SmtSolver solver, Sort sort, TermCache& cache) {
+  if (Term term = cache.find(this)) return term;
+  Term ident = cache.getConstructor(solver, sort, id_);
+  return cache.add(this, solver->make_term(Apply_Constructor, ident));
 }
 
 bool BIdent::contains(AbstractSolverElement::shared_ptr var) { return false; }
@@ -61,11 +109,14 @@ string BCartesianProduct::toSMT() {
   return "(PRODUCT " + left_->toSMT() + " " + right_->toSMT() + ")";
 }
 
-Term BCartesianProduct::getTerm(SmtSolver solver, Sort sort) {
-  Term left_term = left_->getTerm(solver, sort);
-  Term right_term = right_->getTerm(solver, sort);
-  Term product = solver->get_constructor(sort, "PRODUCT");
-  return solver->make_term(Apply_Constructor, product, left_term, right_term);
+Term BCartesianProduct::getTerm(SmtSolver solver, Sort sort,
+                               TermCache& cache) {
+  if (Term term = cache.find(this)) return term;
+  Term left_term = left_->getTerm(solver, sort, cache);
+  Term right_term = right_->getTerm(solver, sort, cache);
+  Term product = cache.getConstructor(solver, sort, "PRODUCT");
+  return cache.add(this, solver->make_term(Apply_Constructor, product,
+                                           left_term, right_term));
 }
 
 bool BCartesianProduct::contains(AbstractSolverElement::shared_ptr var) {
@@ -92,10 +143,12 @@ BPow::BPow(AbstractBType::shared_ptr type) : type_(type) {}
 
 string BPow::toSMT() { return "(POW " + type_->toSMT() + ")"; }
 
-Term BPow::getTerm(SmtSolver solver, Sort sort) {
-  Term internal_term = type_->getTerm(solver, sort);
-  Term pow = solver->get_constructor(sort, "POW");
-  return solver->make_term(Apply_Constructor, pow, internal_term);
+Term BPow::getTerm(SmtSolver solver, Sort sort, TermCache& cache) {
+  if (Term term = cache.find(this)) return term;
+  Term internal_term = type_->getTerm(solver, sort, cache);
+  Term pow = cache.getConstructor(solver, sort, "POW");
+  return cache.add(this,
+                   solver->make_term(Apply_Constructor, pow, internal_term));
 }
 
 bool BPow::contains(AbstractSolverElement::shared_ptr var) {
@@ -110,25 +163,29 @@ AbstractBType::shared_ptr BPow::getType() { return type_; }
 
 // Implementation of the Variable class
 
-int Variable::cpt_ = 0;
-
-Variable::Variable(string id) : id_(id), numeric_id_(cpt_++) {}
+Variable::Variable() : numeric_id_(Session::getCurrent()->nextVariableId()) {}
 
 string Variable::getSMTDeclaration() {
-  return "(declare-fun " + id_ + " () Type)";
+  return "(declare-fun " + toSMT() + " () Type)";
 }
 
-Term Variable::getTerm(SmtSolver solver, Sort sort) {
-  return solver->get_symbol(id_);
+Term Variable::getTerm(SmtSolver /*solver*/, Sort sort, TermCache& cache) {
+  if (Term term = cache.find(this)) return term;
+  // The solver may declare the symbols of other models
+  auto symbol = cache.symbols.find(numeric_id_);
+  if (symbol == cache.symbols.end())
+    throw IncorrectUsageException("Symbol " + toSMT() + " is not declared");
+  return cache.add(this, symbol->second);
 }
 
-string Variable::toSMT() { return id_; }
+string Variable::toSMT() { return "type__" + to_string(numeric_id_); }
 
 bool Variable::contains(AbstractSolverElement::shared_ptr var) {
-  return var->toSMT() == toSMT();
+  Variable::shared_ptr variable = dynamic_pointer_cast<Variable>(var);
+  return variable != nullptr and variable->numeric_id_ == numeric_id_;
 }
 
-string Variable::toString() { return id_; }
+string Variable::toString() { return toSMT(); }
 
 set<int> Variable::getVariables() { return {numeric_id_}; }
 
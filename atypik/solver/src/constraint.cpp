@@ -24,19 +24,21 @@
  */
 #include "constraint.h"
 
+#include "session.h"
 #include "smt.h"
 
 using namespace smt;
+using std::dynamic_pointer_cast;
+using std::function;
 using std::set;
 using std::string;
 
 namespace solver {
 // Implementation of the AbstractConstraint class
 
-unsigned int AbstractConstraint::cpt_ = 0;
-
 AbstractConstraint::AbstractConstraint() {
-  id_ = "constraint__" + std::to_string(cpt_++);
+  id_ = "constraint__" +
+        std::to_string(Session::getCurrent()->nextConstraintId());
 }
 
 string AbstractConstraint::getId() { return id_; }
@@ -61,15 +63,21 @@ set<int> Equals::getVariables() {
   return result;
 }
 
-Term Equals::getTerm(SmtSolver solver, Sort sort) {
-  return solver->make_term(Equal, left_->getTerm(solver, sort),
-                           right_->getTerm(solver, sort));
+Term Equals::getTerm(SmtSolver solver, Sort sort, TermCache& cache) {
+  if (Term term = cache.find(this)) return term;
+  Term left = left_->getTerm(solver, sort, cache);
+  Term right = right_->getTerm(solver, sort, cache);
+  return cache.add(this, solver->make_term(Equal, left, right));
 }
 
 string Equals::toString() {
   return left_->toString() + " = " + right_->toString();
 }
 
+AbstractTerm::shared_ptr Equals::getLeft() { return left_; }
+
+AbstractTerm::shared_ptr Equals::getRight() { return right_; }
+
 // Implementation of the Or class
 
 Or::Or(AbstractTerm::shared_ptr left, AbstractTerm::shared_ptr right)
@@ -90,15 +98,21 @@ set<int> Or::getVariables() {
   return result;
 }
 
-Term Or::getTerm(SmtSolver solver, Sort sort) {
-  return solver->make_term(smt::Or, left_->getTerm(solver, sort),
-                           right_->getTerm(solver, sort));
+Term Or::getTerm(SmtSolver solver, Sort sort, TermCache& cache) {
+  if (Term term = cache.find(this)) return term;
+  Term left = left_->getTerm(solver, sort, cache);
+  Term right = right_->getTerm(solver, sort, cache);
+  return cache.add(this, solver->make_term(smt::Or, left, right));
 }
 
 string Or::toString() {
   return left_->toString() + " or " + right_->toString();
 }
 
+AbstractTerm::shared_ptr Or::getLeft() { return left_; }
+
+AbstractTerm::shared_ptr Or::getRight() { return right_; }
+
 // Implementation of the Not class
 
 Not::Not(AbstractTerm::shared_ptr term) : term_(term) {}
@@ -113,10 +127,36 @@ bool Not::contains(AbstractSolverElement::shared_ptr var) {
 
 set<int> Not::getVariables() { return term_->getVariables(); }
 
-Term Not::getTerm(SmtSolver solver, Sort sort) {
-  return solver->make_term(smt::Not, term_->getTerm(solver, sort));
+Term Not::getTerm(SmtSolver solver, Sort sort, TermCache& cache) {
+  if (Term term = cache.find(this)) return term;
+  Term operand = term_->getTerm(solver, sort, cache);
+  return cache.add(this, solver->make_term(smt::Not, operand));
 }
 
 string Not::toString() { return "not" + term_->toString(); }
 
+AbstractTerm::shared_ptr Not::getOperand() { return term_; }
+
+string formatTerm(AbstractTerm::shared_ptr term,
+                  const function<string(int)>& describe) {
+  if (auto variable = dynamic_pointer_cast<Variable>(term)) {
+    string description = describe(variable->getNumericId());
+    return description.empty() ? variable->toSMT() : description;
+  }
+  if (auto equals = dynamic_pointer_cast<Equals>(term))
+    return formatTerm(equals->getLeft(), describe) + " = " +
+           formatTerm(equals->getRight(), describe);
+  if (auto disjunction = dynamic_pointer_cast<Or>(term))
+    return "(or " + formatTerm(disjunction->getLeft(), describe) + " " +
+           formatTerm(disjunction->getRight(), describe) + ")";
+  if (auto negation = dynamic_pointer_cast<Not>(term))
+    return "(not " + formatTerm(negation->getOperand(), describe) + ")";
+  if (auto pow = dynamic_pointer_cast<BPow>(term))
+    return "(POW " + formatTerm(pow->getType(), describe) + ")";
+  if (auto product = dynamic_pointer_cast<BCartesianProduct>(term))
+    return "(PRODUCT " + formatTerm(product->getLeft(), describe) + " " +
+           formatTerm(product->getRight(), describe) + ")";
+  return term->toSMT();
+}
+
 }  // namespace solver
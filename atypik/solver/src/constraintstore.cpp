@@ -0,0 +1,85 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#include "constraintstore.h"
+
+#include <unordered_set>
+
+using std::move;
+using std::span;
+using std::unordered_set;
+using std::vector;
+
+namespace solver {
+
+void ConstraintStore::add(Assertion::shared_ptr assertion) {
+  assertions_.push_back(assertion);
+  if (not assertion->isUnifiable()) not_unifiable_++;
+  unique_ = unique_ and assertions_.size() == 1;
+}
+
+void ConstraintStore::add(const ConstraintStore &store) {
+  if (store.empty()) return;
+  unique_ = unique_ and store.unique_ and assertions_.empty();
+  assertions_.insert(assertions_.end(), store.assertions_.begin(),
+                     store.assertions_.end());
+  not_unifiable_ += store.not_unifiable_;
+}
+
+void ConstraintStore::add(const ConstraintStore &store, size_t index) {
+  add(store.assertions_[index]);
+}
+
+void ConstraintStore::removeDuplicates() {
+  if (unique_) return;
+  // The set only lives during the pass, the store keeps no index
+  unordered_set<Assertion *> seen;
+  seen.reserve(assertions_.size());
+  size_t kept = 0;
+  not_unifiable_ = 0;
+  for (size_t i = 0; i < assertions_.size(); i++) {
+    if (not seen.insert(assertions_[i].get()).second) continue;
+    if (not assertions_[i]->isUnifiable()) not_unifiable_++;
+    if (kept != i) assertions_[kept] = move(assertions_[i]);
+    kept++;
+  }
+  assertions_.resize(kept);
+  unique_ = true;
+}
+
+size_t ConstraintStore::size() const { return assertions_.size(); }
+
+bool ConstraintStore::empty() const { return assertions_.empty(); }
+
+const vector<Assertion::shared_ptr> &ConstraintStore::getAssertions() const {
+  return assertions_;
+}
+
+span<const int> ConstraintStore::getVariables(size_t index) const {
+  return assertions_[index]->getVariableIds();
+}
+
+bool ConstraintStore::isUnifiable() const { return not_unifiable_ == 0; }
+
+}  // namespace solver
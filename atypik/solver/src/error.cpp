@@ -24,50 +24,56 @@
  */
 #include "error.h"
 
-#include <regex>
+#include "constraint.h"
 
-#include "cvc5_factory.h"
-#include "smt.h"
-
-using namespace smt;
-
-using std::pair;
-using std::regex;
-using std::regex_replace;
+using std::function;
+using std::set;
 using std::string;
-using std::unordered_map;
+using std::to_string;
 using std::vector;
 
 namespace solver {
 
 SolverError::SolverError(std::string message) : message_(message) {}
 
-SolverError::SolverError(UnorderedTermSet unsolved_terms) {
-  message_ =
-      "Model is unsatisfiable. The following constraints are not compatible:\n";
-  for (auto&& term : unsolved_terms) {
-    int cpt = 0;
-    for (auto it = term->begin(); it != term->end(); it++) {
-      if (cpt == 0)
-        message_ += "\t" + (*it)->to_string() + " = ";
-      else if (cpt == 1)
-        message_ += (*it)->to_string() + "\n";
-      cpt++;
-    }
+SolverError::SolverError(string message, vector<Assertion::shared_ptr> unsolved)
+    : header_(message) {
+  for (auto&& assertion : unsolved) {
+    unsolved_.push_back(assertion->getConstraint());
+    provenances_.push_back(assertion->getProvenance());
   }
+  buildMessage([](int) { return string(); });
 }
 
 const char* SolverError::what() const noexcept { return message_.c_str(); }
 
-void SolverError::replaceTerms(unordered_map<string, string> terms) {
-  for (auto [old_term, new_term] : terms) {
-    regex re(string(R"()") + old_term + "\\)" + string(R"()"));
-    message_ = regex_replace(message_, re, new_term + ")");
-    re = string(R"()") + old_term + " " + string(R"()");
-    message_ = regex_replace(message_, re, new_term + " ");
-    re = string(R"()") + old_term + "\n" + string(R"()");
-    message_ = regex_replace(message_, re, new_term + "\n");
+void SolverError::describeVariables(const function<string(int)>& describe) {
+  if (not unsolved_.empty()) buildMessage(describe);
+}
+
+set<int> SolverError::getVariableIds() const {
+  set<int> result;
+  for (auto&& term : unsolved_) result.merge(term->getVariables());
+  return result;
+}
+
+void SolverError::buildMessage(const function<string(int)>& describe) {
+  message_ = header_;
+  for (size_t i = 0; i < unsolved_.size(); i++) {
+    message_ += "\t" + formatTerm(unsolved_[i], describe);
+    if (provenances_[i].isKnown())
+      message_ += " (from " + provenances_[i].toString() + ")";
+    message_ += "\n";
   }
 }
 
+SolverLimitError::SolverLimitError(size_t assertions, size_t variables)
+    : message_("A model with " + to_string(assertions) + " assertions and " +
+               to_string(variables) +
+               " variables exceeded the limits of the solver") {}
+
+const char* SolverLimitError::what() const noexcept {
+  return message_.c_str();
+}
+
 }  // namespace solver
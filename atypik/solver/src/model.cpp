@@ -24,26 +24,34 @@
  */
 #include "model.h"
 
+#include <algorithm>
+#include <cstdint>
+
 #include "chrono"
-#include "cvc5_factory.h"
 #include "error.h"
+#include "session.h"
 #include "smt.h"
-
-#include <regex>
+#include "solverfactory.h"
+#include "unifier.h"
 
 using namespace smt;
 
 using std::dynamic_pointer_cast;
+using std::pair;
 using std::set;
 using std::shared_ptr;
+using std::span;
 using std::string;
 using std::unordered_map;
+using std::unordered_set;
+using std::vector;
 
 namespace solver
 {
 
-  Model::Model()
-      : initialized_(false), solver_(Cvc5SolverFactory::create(false)) {}
+  // The solver is borrowed from the pool of the session when the model is
+  // solved
+  Model::Model() : session_(Session::getCurrent()) {}
 
   std::string Model::toSMT()
   {
@@ -52,7 +60,7 @@ namespace solver
            SMTGetValues() + "\n";
   }
 
-  void Model::add(Assertion::shared_ptr to_add) { assertions_.emplace(to_add); }
+  void Model::add(Assertion::shared_ptr to_add) { assertions_.add(to_add); }
 
   void Model::add(Variable::shared_ptr to_add) { variables_.emplace(to_add); }
 
@@ -84,7 +92,7 @@ namespace solver
   string Model::SMTAssertions()
   {
     string result = "; Assertions\n";
-    for (auto &&assertion : assertions_)
+    for (auto &&assertion : assertions_.getAssertions())
     {
       result += assertion->toSMT() + "\n";
     }
@@ -112,42 +120,33 @@ namespace solver
            "(set-option :produce-unsat-cores true)\n";
   }
 
-  void Model::setOptions()
+  void Model::acquireSolver()
   {
-    solver_ = Cvc5SolverFactory::create(false);
-    solver_->set_opt("produce-models", "true");
-    solver_->set_opt("produce-unsat-assumptions", "true");
-    solver_->set_logic("QF_UFDT");
+    instance_ = session_->getSolverPool().acquire(datatypes_);
+    // The cached terms belong to the previous solver
+    term_cache_ = TermCache();
+    addVariables(variables_);
   }
 
-  void Model::addDataTypes()
+  void Model::releaseSolver()
   {
-    types_ = solver_->make_datatype_decl("types");
-    DatatypeConstructorDecl pow = solver_->make_datatype_constructor_decl("POW");
-    DatatypeConstructorDecl prod =
-        solver_->make_datatype_constructor_decl("PRODUCT");
-    solver_->add_selector_self(pow, "T");
-    solver_->add_selector_self(prod, "A");
-    solver_->add_selector_self(prod, "B");
-    solver_->add_constructor(types_, pow);
-    solver_->add_constructor(types_, prod);
-    for (auto &&datatype : datatypes_)
-    {
-      string type_name = datatype->toSMT();
-      DatatypeConstructorDecl type =
-          solver_->make_datatype_constructor_decl(type_name);
-      solver_->add_constructor(types_, type);
-    }
-    type_sort_ = solver_->make_sort(types_);
+    session_->getSolverPool().release(instance_);
+    instance_ = nullptr;
   }
 
-  void Model::addVariables()
+  void Model::addVariables(const unordered_set<Variable::shared_ptr> &variables)
   {
-    for (auto &&variable : variables_)
+    for (auto &&variable : variables)
     {
-      string id = variable->toSMT();
-      Term new_term = solver_->make_symbol(id, type_sort_);
-      terms_[id] = new_term;
+      int id = variable->getNumericId();
+      if (term_cache_.symbols.contains(id))
+        continue;
+      // The symbols are kept by the solver when a scope is closed or when
+      // its assertions are reset, so that they are declared once per solver
+      if (not instance_->symbols.contains(id))
+        instance_->symbols[id] = instance_->solver->make_symbol(
+            variable->toSMT(), instance_->type_sort);
+      term_cache_.symbols[id] = instance_->symbols[id];
     }
   }
 
@@ -156,93 +155,365 @@ namespace solver
     datatypes_.insert(datatypes_.end(), model->datatypes_.begin(),
                       model->datatypes_.end());
     variables_.insert(model->variables_.begin(), model->variables_.end());
-    assertions_.insert(model->assertions_.begin(), model->assertions_.end());
+    assertions_.add(model->assertions_);
   }
 
-  string Model::instanciateTerm(string &term)
+  vector<Model::shared_ptr> Model::split()
   {
-    int open_parenthesis = 0;
-    int current_index = 0;
-    string current_word, var, val;
-    // A boolean telling if we are reading a variable introduced by a let
-    bool in_var = false;
-    bool in_val = false;
-    // The parenthesis of the let is always removed
-    int removed_parenthesis = 1;
-
-    // We look for the value of the introduced variable
-    for (const auto &c : term)
+    assertions_.removeDuplicates();
+    // A union-find on the numeric ids of the variables
+    unordered_map<int, int> parent;
+    auto find = [&parent](int id)
     {
-      if (c == ' ')
+      int root = id;
+      while (parent[root] != root)
+        root = parent[root];
+      while (parent[id] != root)
       {
-        if (current_word == "(let")
-        {
-          in_var = true;
-          current_word = "";
-        }
+        int next = parent[id];
+        parent[id] = root;
+        id = next;
+      }
+      return root;
+    };
 
-        else if (in_var)
-        {
-          // The opening parenthesis must be removed
-          current_word = current_word.substr(open_parenthesis, current_word.size());
-          removed_parenthesis += open_parenthesis;
-          var = current_word;
-          in_var = false;
-          in_val = true;
-          current_word = "";
-        }
+    for (auto &&variable : variables_)
+      parent[variable->getNumericId()] = variable->getNumericId();
+    for (size_t i = 0; i < assertions_.size(); i++)
+    {
+      span<const int> ids = assertions_.getVariables(i);
+      for (int id : ids)
+        if (not parent.contains(id))
+          parent[id] = id;
+      if (not ids.empty())
+      {
+        int root = find(ids.front());
+        for (int id : ids)
+          parent[find(id)] = root;
+      }
+    }
 
-        else if (in_val and open_parenthesis == 1)
-        {
-          current_word = current_word.substr(0, current_word.size() - 2);
-          val = current_word;
-          break;
-        }
+    // Each connected component becomes a model
+    vector<Model::shared_ptr> result;
+    unordered_map<int, Model::shared_ptr> root_to_model;
+    auto getComponent = [this, &result, &root_to_model](int root)
+    {
+      if (not root_to_model.contains(root))
+      {
+        Model::shared_ptr component = std::make_shared<Model>();
+        component->datatypes_ = datatypes_;
+        root_to_model[root] = component;
+        result.push_back(component);
       }
+      return root_to_model[root];
+    };
 
-      current_word += c;
-      ++current_index;
+    for (size_t i = 0; i < assertions_.size(); i++)
+    {
+      span<const int> ids = assertions_.getVariables(i);
+      // Assertions without variables are kept in their own component
+      int root = ids.empty() ? -1 : find(ids.front());
+      getComponent(root)->assertions_.add(assertions_, i);
+    }
+    for (auto &&variable : variables_)
+    {
+      int root = find(variable->getNumericId());
+      // The unconstrained variables are gathered in a single component
+      if (not root_to_model.contains(root))
+        root = -2;
+      getComponent(root)->add(variable);
+    }
+    return result;
+  }
 
-      if (c == '(')
-        ++open_parenthesis;
+  size_t Model::getCost() { return assertions_.size() + variables_.size(); }
 
-      if (c == ')')
-        --open_parenthesis;
+  vector<Model::shared_ptr> Model::batch(const vector<Model::shared_ptr> &models,
+                                         size_t budget, vector<size_t> &indexes)
+  {
+    indexes.clear();
+    if (budget == 0)
+    {
+      for (size_t i = 0; i < models.size(); i++)
+        indexes.push_back(i);
+      return models;
     }
 
-    // Triming val
-    while (val[0] == ' ')
-      val = val.substr(1, val.size());
+    vector<Model::shared_ptr> result;
+    vector<size_t> costs;
+    // The last batch of the models solved by unification and of the other
+    // ones, so that a SMT model does not take a batch out of the unifier
+    size_t last[2] = {SIZE_MAX, SIZE_MAX};
+    // The last batch using each variable
+    unordered_map<int, size_t> batches;
+    for (auto &&model : models)
+    {
+      // The variables of the assertions are taken into account, as the
+      // assertions on undeclared variables are ignored
+      set<int> ids = model->getVariables();
+      for (size_t i = 0; i < model->assertions_.size(); i++)
+        for (int id : model->assertions_.getVariables(i))
+          ids.insert(id);
+
+      // A model sharing a variable with the last batch would be solved with
+      // the models of the batch, so a new batch is started after it
+      size_t cost = model->getCost();
+      size_t &index = last[model->isUnificationProblem() ? 0 : 1];
+      bool packed = index != SIZE_MAX and costs[index] + cost <= budget;
+      for (auto id = ids.begin(); packed and id != ids.end(); id++)
+      {
+        auto batch = batches.find(*id);
+        packed = batch == batches.end() or batch->second < index;
+      }
+      if (not packed)
+      {
+        index = result.size();
+        result.push_back(std::make_shared<Model>());
+        costs.push_back(0);
+      }
+      result[index]->merge(model);
+      costs[index] += cost;
+      indexes.push_back(index);
+      for (int id : ids)
+        batches[id] = index;
+    }
+    return result;
+  }
 
-    // Removing "let( " and ")"
-    term = term.substr(current_index, term.size());
-    term.pop_back();
+  string Model::getCanonicalForm(vector<Variable::shared_ptr> &variables)
+  {
+    // The assertions are sorted by their shape, then the variables are named
+    // in the order of their first occurrence
+    assertions_.removeDuplicates();
+    vector<pair<string, AbstractConstraint::shared_ptr>> shapes;
+    shapes.reserve(assertions_.size());
+    for (auto &&assertion : assertions_.getAssertions())
+    {
+      AbstractConstraint::shared_ptr constraint = assertion->getConstraint();
+      shapes.emplace_back(formatTerm(constraint, [](int) { return "?"; }),
+                          constraint);
+    }
+    std::sort(shapes.begin(), shapes.end(),
+              [](const auto &a, const auto &b) { return a.first < b.first; });
 
-    while (term[0] == ' ')
-      term.erase(0, 1);
+    unordered_map<int, size_t> names;
+    auto rename = [&names](int id)
+    {
+      auto name = names.emplace(id, names.size()).first;
+      return "?" + std::to_string(name->second);
+    };
 
-    return std::regex_replace(term, std::regex(var), val);
+    vector<string> datatypes;
+    for (auto &&datatype : datatypes_)
+      datatypes.push_back(datatype->toSMT());
+    std::sort(datatypes.begin(), datatypes.end());
+    datatypes.erase(std::unique(datatypes.begin(), datatypes.end()),
+                    datatypes.end());
+    string result = "types";
+    for (auto &&datatype : datatypes)
+      result += " " + datatype;
+    result += "\n";
+    for (auto &&shape : shapes)
+      result += formatTerm(shape.second, rename) + "\n";
+
+    // The unconstrained variables are interchangeable, they are named last
+    vector<pair<size_t, Variable::shared_ptr>> declared;
+    for (auto &&variable : variables_)
+      if (names.contains(variable->getNumericId()))
+        declared.emplace_back(names[variable->getNumericId()], variable);
+    for (auto &&variable : variables_)
+      if (not names.contains(variable->getNumericId()))
+      {
+        rename(variable->getNumericId());
+        declared.emplace_back(names[variable->getNumericId()], variable);
+      }
+    std::sort(declared.begin(), declared.end(),
+              [](const auto &a, const auto &b) { return a.first < b.first; });
+    result += "declare";
+    variables.clear();
+    for (auto &&[name, variable] : declared)
+    {
+      result += " ?" + std::to_string(name);
+      variables.push_back(variable);
+    }
+    result += "\n";
+    return result;
   }
 
-  unordered_map<Variable::shared_ptr, std::string> Model::solve()
+  vector<Model::shared_ptr>
+  Model::seed(const vector<Model::shared_ptr> &models,
+              const Solution &solution)
   {
-    if (not initialized_)
+    Factory factory;
+    unordered_map<int, Variable::shared_ptr> variables;
+    // The assertions binding the variables whose type is ground
+    unordered_map<int, Assertion::shared_ptr> bindings;
+    // The components whose types are not ground, by variable id
+    unordered_map<int, Model::shared_ptr> components;
+    for (auto &&component : split())
     {
-      setOptions();
-      addDataTypes();
-      addVariables();
-      initialized_ = true;
+      bool ground = true;
+      for (auto &&variable : component->variables_)
+      {
+        AbstractBType::shared_ptr value = solution.get(variable);
+        if (value == nullptr or not isGround(value))
+          ground = false;
+      }
+      for (auto &&variable : component->variables_)
+      {
+        int id = variable->getNumericId();
+        variables[id] = variable;
+        if (ground)
+          bindings[id] =
+              factory.makeAssertEquals(variable, solution.get(variable));
+        else
+          components[id] = component;
+      }
+      if (not ground)
+        for (size_t i = 0; i < component->assertions_.size(); i++)
+          for (int id : component->assertions_.getVariables(i))
+            components[id] = component;
     }
 
-    unordered_map<Variable::shared_ptr, string> result;
+    vector<Model::shared_ptr> result;
+    result.reserve(models.size());
+    for (auto &&model : models)
+    {
+      Model::shared_ptr seeded = std::make_shared<Model>();
+      seeded->merge(model);
+      // The bindings may use the data types of the current model
+      unordered_set<string> names;
+      for (auto &&datatype : seeded->datatypes_)
+        names.insert(datatype->toSMT());
+      for (auto &&datatype : datatypes_)
+        if (names.insert(datatype->toSMT()).second)
+          seeded->add(datatype);
+
+      unordered_set<Model::shared_ptr> merged;
+      for (size_t i = 0; i < model->assertions_.size(); i++)
+        for (int id : model->assertions_.getVariables(i))
+        {
+          if (bindings.contains(id))
+          {
+            seeded->add(variables[id]);
+            seeded->add(bindings[id]);
+          }
+          else if (components.contains(id) and
+                   merged.insert(components[id]).second)
+            seeded->merge(components[id]);
+        }
+      result.push_back(seeded);
+    }
+    return result;
+  }
+
+  bool Model::isGround(AbstractBType::shared_ptr type)
+  {
+    if (BPow::shared_ptr pow = dynamic_pointer_cast<BPow>(type))
+      return isGround(pow->getType());
+    if (BCartesianProduct::shared_ptr product =
+            dynamic_pointer_cast<BCartesianProduct>(type))
+      return isGround(product->getLeft()) and isGround(product->getRight());
+    return type->toSMT() != "A";
+  }
+
+  bool Model::isUnificationProblem()
+  {
+    // Or and Not constraints need a SMT solver
+    return assertions_.isUnifiable();
+  }
+
+  Typing Model::solveByUnification()
+  {
+    Unifier unifier(datatypes_);
+    unifier.declare(variables_);
+    for (auto &assertion : assertions_.getAssertions())
+      unifier.add(assertion);
+    return unifier.solve(variables_);
+  }
+
+  Typing
+  Model::solveIncrementallyByUnification(const vector<Model::shared_ptr> &models)
+  {
+    Unifier unifier(datatypes_);
+    unifier.declare(variables_);
+    for (auto &assertion : assertions_.getAssertions())
+      unifier.add(assertion);
+    Typing result = unifier.solve(variables_);
+
+    // The variables of the current model keep the type found above, so only
+    // the variables of each model are read in its scope
+    for (auto &&model : models)
+    {
+      unifier.push();
+      unifier.declare(model->variables_);
+      for (auto &assertion : model->assertions_.getAssertions())
+        unifier.add(assertion);
+      Typing typing = unifier.solve(model->variables_);
+      result.insert(result.end(), typing.begin(), typing.end());
+      unifier.pop();
+    }
+
+    return result;
+  }
+
+  Typing Model::solve()
+  {
+    assertions_.removeDuplicates();
+    if (isUnificationProblem())
+      return solveByUnification();
+
+    acquireSolver();
+    Typing result;
+    try
+    {
+      result = check(assertions_, variables_);
+    }
+    catch (...)
+    {
+      releaseSolver();
+      throw;
+    }
+    releaseSolver();
+    return result;
+  }
+
+  AbstractBType::shared_ptr
+  Model::getType(const Term &value, Factory &factory,
+                 unordered_map<Term, AbstractBType::shared_ptr> &types)
+  {
+    if (types.contains(value))
+      return types[value];
+
+    // A value is the application of a constructor, which is its first child
+    vector<Term> children;
+    for (auto child = value->begin(); child != value->end(); ++child)
+      children.push_back(*child);
+    string constructor =
+        children.empty() ? value->to_string() : children[0]->to_string();
+
+    AbstractBType::shared_ptr result;
+    if (constructor == "POW" and children.size() == 2)
+      result = factory.makeBPow(getType(children[1], factory, types));
+    else if (constructor == "PRODUCT" and children.size() == 3)
+      result =
+          factory.makeBCartesianProduct(getType(children[1], factory, types),
+                                        getType(children[2], factory, types));
+    else
+      result = factory.makeBIdent(constructor);
+    return types[value] = result;
+  }
 
-    UnorderedTermSet assertions;
-    for (auto &assertion : assertions_)
+  UnorderedTermSet
+  Model::getTerms(const ConstraintStore &assertions)
+  {
+    UnorderedTermSet result;
+    for (auto &assertion : assertions.getAssertions())
     {
       try
       {
-        assertions.insert(
-            assertion->getConstraint()->getTerm(solver_, type_sort_));
+        result.insert(assertion->getConstraint()->getTerm(
+            instance_->solver, instance_->type_sort, term_cache_));
       }
       catch (IncorrectUsageException e)
       {
@@ -250,25 +521,147 @@ namespace solver
         continue;
       }
     }
+    return result;
+  }
 
-    Result model_result = solver_->check_sat_assuming_set(assertions);
+  vector<Assertion::shared_ptr>
+  Model::getCore(const UnorderedTermSet &unsolved,
+                 const ConstraintStore &assertions)
+  {
+    // The terms of the checked assertions are in the cache, so the core is
+    // mapped back to its assertions without printing any term
+    vector<Assertion::shared_ptr> result;
+    for (auto &assertion : assertions.getAssertions())
+    {
+      Term term = term_cache_.find(assertion->getConstraint().get());
+      if (term != nullptr and unsolved.contains(term))
+        result.push_back(assertion);
+    }
+    return result;
+  }
 
+  vector<Assertion::shared_ptr>
+  Model::explain(const ConstraintStore &assertions,
+                 const unordered_set<Variable::shared_ptr> &variables)
+  {
+    Model explanation;
+    explanation.datatypes_ = datatypes_;
+    explanation.variables_ = variables;
+    explanation.variables_.insert(variables_.begin(), variables_.end());
+    explanation.assertions_ = assertions_;
+    explanation.assertions_.add(assertions);
+    explanation.assertions_.removeDuplicates();
+    // The explanation needs a solver tracking the assumptions, which is not
+    // taken from the pool
+    explanation.session_ = session_;
+    explanation.instance_ = session_->getSolverPool().make(datatypes_, true);
+    explanation.addVariables(explanation.variables_);
+
+    SmtSolver solver = explanation.instance_->solver;
+    Result explanation_result = solver->check_sat_assuming_set(
+        explanation.getTerms(explanation.assertions_));
+    // The explanation may exceed the limits of the solver
+    if (not explanation_result.is_unsat())
+      return {};
+    UnorderedTermSet unsolved;
+    solver->get_unsat_assumptions(unsolved);
+    return explanation.getCore(unsolved, explanation.assertions_);
+  }
+
+  Typing
+  Model::check(const ConstraintStore &assertions,
+               const unordered_set<Variable::shared_ptr> &variables)
+  {
+    Typing result;
+    result.reserve(variables.size());
+
+    // The fast path asserts the constraints directly, the unsat core is only
+    // computed by a second solver when the check fails
+    for (auto &term : getTerms(assertions))
+      instance_->solver->assert_formula(term);
+    Result model_result = instance_->solver->check_sat();
+
+    if (model_result.is_unknown())
+      throw SolverLimitError(assertions.size(), variables.size());
     if (not model_result.is_sat())
+      throw SolverError(
+          "Model is unsatisfiable. The following constraints are not "
+          "compatible:\n",
+          explain(assertions, variables));
+
+    // The values are read as terms, their shared subterms being converted
+    // once
+    Factory factory;
+    unordered_map<Term, AbstractBType::shared_ptr> types;
+    for (auto &var : variables)
     {
-      UnorderedTermSet unsolved;
-      solver_->get_unsat_assumptions(unsolved);
-      throw SolverError(unsolved);
+      Term value = instance_->solver->get_value(
+          term_cache_.symbols[var->getNumericId()]);
+      result.emplace_back(var->getNumericId(), getType(value, factory, types));
     }
 
-    for (auto &var : variables_)
+    return result;
+  }
+
+  Typing
+  Model::solveIncrementally(const vector<Model::shared_ptr> &models,
+                            vector<SolverLimitError> &exceeded)
+  {
+    // The data types of all the models are declared once
+    unordered_set<string> names;
+    vector<BIdent::shared_ptr> datatypes;
+    for (auto &&datatype : datatypes_)
+      if (names.insert(datatype->toSMT()).second)
+        datatypes.push_back(datatype);
+    for (auto &&model : models)
+      for (auto &&datatype : model->datatypes_)
+        if (names.insert(datatype->toSMT()).second)
+          datatypes.push_back(datatype);
+    datatypes_ = datatypes;
+
+    // Each model of the range belongs to the current thread
+    assertions_.removeDuplicates();
+    for (auto &&model : models)
+      model->assertions_.removeDuplicates();
+    bool unification = isUnificationProblem();
+    for (auto &&model : models)
+      unification = unification and model->isUnificationProblem();
+    if (unification)
+      return solveIncrementallyByUnification(models);
+
+    acquireSolver();
+    SmtSolver solver = instance_->solver;
+    Typing result;
+    try
     {
-      string name = var->toSMT();
-      string value = solver_->get_value(terms_[name])->to_string();
-      while (value.find("let") != string::npos)
-        value = Model::instanciateTerm(value);
-      result[var] = value;
-    }
+      // The shared assertions are checked alone first, they are kept at the
+      // base level of the solver. Their variables keep the type found here,
+      // so only the variables of each model are read in its scope.
+      result = check(assertions_, variables_);
 
+      for (auto &&model : models)
+      {
+        solver->push();
+        addVariables(model->variables_);
+        // A model exceeding the limits is skipped, the next ones are solved
+        try
+        {
+          Typing typing = check(model->assertions_, model->variables_);
+          result.insert(result.end(), typing.begin(), typing.end());
+        }
+        catch (const SolverLimitError &e)
+        {
+          exceeded.push_back(e);
+        }
+        solver->pop();
+      }
+    }
+    catch (...)
+    {
+      releaseSolver();
+      throw;
+    }
+    releaseSolver();
     return result;
   }
 
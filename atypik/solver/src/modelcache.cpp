@@ -0,0 +1,172 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#include "modelcache.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <unordered_map>
+
+#include "solverfactory.h"
+
+using std::error_code;
+using std::ifstream;
+using std::move;
+using std::ofstream;
+using std::string;
+using std::to_string;
+using std::unordered_map;
+using std::vector;
+namespace filesystem = std::filesystem;
+
+namespace solver {
+
+ModelCache::ModelCache(string directory) : directory_(directory) {
+  error_code error;
+  filesystem::create_directories(directory_, error);
+}
+
+string ModelCache::getDefaultDirectory() {
+  const char *cache = getenv("XDG_CACHE_HOME");
+  if (cache != nullptr and *cache != '\0') return string(cache) + "/atypik";
+  const char *home = getenv("HOME");
+  return string(home != nullptr ? home : ".") + "/.cache/atypik";
+}
+
+bool ModelCache::lookup(
+    Model::shared_ptr model, Typing &solution) {
+  vector<Variable::shared_ptr> variables;
+  string canonical_form = model->getCanonicalForm(variables);
+  ifstream file(getPath(canonical_form), std::ios::binary);
+  if (not file) return false;
+
+  // The canonical form is stored to detect the collisions of the hash
+  size_t size;
+  if (not(file >> size) or file.get() != '\n') return false;
+  string stored(size, '\0');
+  if (not file.read(stored.data(), size) or stored != canonical_form)
+    return false;
+
+  Factory factory;
+  Typing result;
+  string line;
+  for (auto &&variable : variables) {
+    if (not getline(file, line)) return false;
+    size_t position = 0;
+    AbstractBType::shared_ptr type = readType(line, position, factory);
+    if (type == nullptr or position != line.size()) return false;
+    result.emplace_back(variable->getNumericId(), type);
+  }
+  solution = move(result);
+  return true;
+}
+
+void ModelCache::store(
+    Model::shared_ptr model, const Typing &solution) {
+  vector<Variable::shared_ptr> variables;
+  string canonical_form = model->getCanonicalForm(variables);
+  unordered_map<int, AbstractBType::shared_ptr> solved(solution.begin(),
+                                                       solution.end());
+  string types;
+  for (auto &&variable : variables) {
+    auto type = solved.find(variable->getNumericId());
+    if (type == solved.end() or type->second == nullptr) return;
+    types += type->second->toSMT() + "\n";
+  }
+
+  // The file is written aside then renamed, so that a concurrent run never
+  // reads a partial file
+  filesystem::path path = getPath(canonical_form);
+  filesystem::path temporary =
+      path.string() + "." + to_string(std::random_device()()) + ".tmp";
+  error_code error;
+  filesystem::create_directories(path.parent_path(), error);
+  {
+    ofstream file(temporary, std::ios::binary);
+    file << canonical_form.size() << "\n" << canonical_form << types;
+    if (not file) {
+      filesystem::remove(temporary, error);
+      return;
+    }
+  }
+  filesystem::rename(temporary, path, error);
+  if (error) filesystem::remove(temporary, error);
+}
+
+string ModelCache::getPath(const string &canonical_form) {
+  // FNV-1a, which unlike std::hash is the same in every run
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : canonical_form) {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  char name[17];
+  snprintf(name, sizeof(name), "%016llx",
+           static_cast<unsigned long long>(hash));
+  return directory_ + "/" + string(name, 2) + "/" + string(name + 2);
+}
+
+AbstractBType::shared_ptr ModelCache::readType(const string &text,
+                                               size_t &position,
+                                               Factory &factory) {
+  if (position >= text.size()) return nullptr;
+  if (text[position] != '(') {
+    size_t end = text.find_first_of(" ()", position);
+    if (end == string::npos) end = text.size();
+    if (end == position) return nullptr;
+    string name = text.substr(position, end - position);
+    position = end;
+    return factory.makeBIdent(name);
+  }
+
+  size_t end = text.find(' ', position);
+  if (end == string::npos) return nullptr;
+  string constructor = text.substr(position + 1, end - position - 1);
+  position = end + 1;
+  AbstractBType::shared_ptr result;
+  if (constructor == "POW") {
+    AbstractBType::shared_ptr type = readType(text, position, factory);
+    if (type == nullptr) return nullptr;
+    result = factory.makeBPow(type);
+  } else if (constructor == "PRODUCT") {
+    AbstractBType::shared_ptr left = readType(text, position, factory);
+    if (left == nullptr or position >= text.size() or text[position] != ' ')
+      return nullptr;
+    position++;
+    AbstractBType::shared_ptr right = readType(text, position, factory);
+    if (right == nullptr) return nullptr;
+    result = factory.makeBCartesianProduct(left, right);
+  } else {
+    return nullptr;
+  }
+  if (position >= text.size() or text[position] != ')') return nullptr;
+  position++;
+  return result;
+}
+
+}  // namespace solver
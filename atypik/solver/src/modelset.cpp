@@ -24,37 +24,230 @@
  */
 #include "modelset.h"
 
+#include <algorithm>
 #include <future>
-#include <thread>
+#include <unordered_map>
+
+#include "threadpool.h"
 
-using std::async;
 using std::future;
-using std::shared_future;
+using std::make_shared;
+using std::move;
+using std::shared_ptr;
 using std::string;
-using std::thread;
 using std::unordered_map;
+using tools::ThreadPool;
 using std::vector;
 
 namespace solver {
-ModelSet::ModelSet(vector<Model::shared_ptr> models) : models_(models) {}
+ModelSet::ModelSet(vector<Model::shared_ptr> models)
+    : models_(models),
+      strategy_(Strategy::Incremental),
+      session_(Session::getCurrent()) {}
+
+ModelSet::ModelSet(Model::shared_ptr base, vector<Model::shared_ptr> models,
+                   Strategy strategy)
+    : models_(models),
+      base_(base),
+      strategy_(strategy),
+      session_(Session::getCurrent()) {}
+
+Solution ModelSet::solve() {
+  exceeded_.clear();
+  Typing typing;
+  if (base_ == nullptr)
+    typing = solve(models_);
+  else if (strategy_ == Strategy::Seeded)
+    typing = solveSeeded();
+  else
+    typing = solveIncrementally();
+  // The dense table is only built for the result, once
+  Solution result(session_->getVariableCount());
+  result.add(typing);
+  return result;
+}
+
+Typing ModelSet::solve(const vector<Model::shared_ptr>& models) {
+  Typing result;
+  ModelCache::shared_ptr cache = session_->getCache();
+  vector<Model::shared_ptr> components;
+  for (auto& model : models) {
+    for (auto& component : model->split()) components.push_back(component);
+  }
+
+  // The components solved by a previous run are read from the cache
+  vector<Typing> solutions(components.size());
+  vector<Model::shared_ptr> unsolved;
+  vector<size_t> positions;
+  for (size_t i = 0; i < components.size(); i++) {
+    if (cache != nullptr and cache->lookup(components[i], solutions[i]))
+      continue;
+    unsolved.push_back(components[i]);
+    positions.push_back(i);
+  }
+
+  // The small components are solved together to save the cost of a solver
+  // call per component
+  vector<size_t> indexes;
+  vector<Model::shared_ptr> batches =
+      Model::batch(unsolved, session_->getBatchCost(), indexes);
+
+  // The batches are solved concurrently by the threads of the shared pool,
+  // the most expensive ones first to avoid a long tail on a single thread
+  vector<size_t> costs(batches.size());
+  vector<size_t> order(batches.size());
+  for (size_t i = 0; i < batches.size(); i++) {
+    costs[i] = batches[i]->getCost();
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&costs](size_t a, size_t b) { return costs[a] > costs[b]; });
+
+  ThreadPool& pool = ThreadPool::getShared();
+  // The tasks may outlive the set if a model throws, so they do not refer to
+  // it
+  auto submit = [&pool, session = session_](Model::shared_ptr model) {
+    return pool.submit([session, model]() {
+      Session::Scope scope(session);
+      return model->solve();
+    });
+  };
+  vector<future<Typing>> model_future_results(batches.size());
+  for (size_t i : order) model_future_results[i] = submit(batches[i]);
+
+  // A batch exceeding the limits is solved again member by member, so that
+  // only the components exceeding the limits on their own are skipped
+  vector<vector<size_t>> members(batches.size());
+  for (size_t i = 0; i < unsolved.size(); i++) members[indexes[i]].push_back(i);
+  vector<Typing> typings(batches.size());
+  vector<future<Typing>> retries(unsolved.size());
+  vector<bool> solved(unsolved.size(), true);
+  for (size_t i = 0; i < batches.size(); i++) {
+    try {
+      typings[i] = model_future_results[i].get();
+    } catch (const SolverLimitError &e) {
+      if (members[i].size() == 1) {
+        exceeded_.push_back(e);
+        solved[members[i][0]] = false;
+        continue;
+      }
+      for (size_t member : members[i])
+        retries[member] = submit(unsolved[member]);
+    }
+  }
+  vector<Typing> retried(unsolved.size());
+  for (size_t i = 0; i < unsolved.size(); i++) {
+    if (not retries[i].valid()) continue;
+    try {
+      retried[i] = retries[i].get();
+    } catch (const SolverLimitError &e) {
+      exceeded_.push_back(e);
+      solved[i] = false;
+    }
+  }
+
+  // Without cache, merging the solutions of the batches in order gives the
+  // solution of the models merged in order
+  if (cache == nullptr) {
+    for (size_t i = 0; i < batches.size(); i++) {
+      result.insert(result.end(), typings[i].begin(), typings[i].end());
+      for (size_t member : members[i])
+        result.insert(result.end(), retried[member].begin(),
+                      retried[member].end());
+    }
+    return result;
+  }
+
+  // Otherwise the solution of each batch is split back per component to be
+  // stored, the components of a batch having distinct variables
+  unordered_map<int, size_t> owners;
+  for (size_t i = 0; i < unsolved.size(); i++)
+    for (int id : unsolved[i]->getVariables()) owners.emplace(id, i);
+  for (size_t i = 0; i < batches.size(); i++) {
+    for (auto& [id, type] : typings[i]) {
+      auto owner = owners.find(id);
+      if (owner != owners.end())
+        solutions[positions[owner->second]].emplace_back(id, move(type));
+    }
+  }
+  for (size_t i = 0; i < unsolved.size(); i++)
+    if (not retried[i].empty()) solutions[positions[i]] = move(retried[i]);
+  for (size_t i = 0; i < unsolved.size(); i++)
+    if (solved[i]) cache->store(unsolved[i], solutions[positions[i]]);
+
+  // The solutions are concatenated in the order of the models
+  for (auto& solution : solutions)
+    result.insert(result.end(), solution.begin(), solution.end());
 
-unordered_map<Variable::shared_ptr, string> ModelSet::solve() {
-  unordered_map<Variable::shared_ptr, string> result;
-  vector<future<unordered_map<Variable::shared_ptr, string>>>
-      model_future_results;
-  model_future_results.reserve(models_.size());
+  return result;
+}
 
-  for (auto& model : models_) {
-    model_future_results.push_back(std::async(&Model::solve, model));
+Typing ModelSet::solveIncrementally() {
+  Typing result;
+  ThreadPool& pool = ThreadPool::getShared();
+  size_t threads = std::min<size_t>(pool.size(), models_.size());
+  threads = std::max<size_t>(1, threads);
+  vector<future<Typing>> model_future_results;
+  model_future_results.reserve(threads);
+  vector<shared_ptr<vector<SolverLimitError>>> exceeded_ranges;
+
+  // Each thread solves a contiguous range of models so that the results are
+  // merged in the order of the models. The ranges have about the same cost.
+  size_t total = 0;
+  for (auto& model : models_) total += model->getCost();
+  auto begin = models_.begin();
+  size_t cost = 0;
+  for (size_t i = 0; i < threads; i++) {
+    auto end = begin;
+    size_t target = total * (i + 1) / threads;
+    while (end != models_.end() and
+           (i + 1 == threads or end == begin or
+            cost + (*end)->getCost() <= target)) {
+      cost += (*end)->getCost();
+      end++;
+    }
+    vector<Model::shared_ptr> models(begin, end);
+    begin = end;
+    // The base model is copied since each thread owns its solver
+    Model::shared_ptr base = make_shared<Model>();
+    base->merge(base_);
+    auto exceeded = make_shared<vector<SolverLimitError>>();
+    exceeded_ranges.push_back(exceeded);
+    model_future_results.push_back(
+        pool.submit([session = session_, base, models, exceeded]() {
+          Session::Scope scope(session);
+          return base->solveIncrementally(models, *exceeded);
+        }));
   }
 
-  for (auto& future_result : model_future_results) {
-    result.merge(future_result.get());
+  for (size_t i = 0; i < threads; i++) {
+    try {
+      Typing typing = model_future_results[i].get();
+      result.insert(result.end(), typing.begin(), typing.end());
+    } catch (const SolverLimitError &e) {
+      // The base model itself exceeded the limits
+      exceeded_.push_back(e);
+    }
+    exceeded_.insert(exceeded_.end(), exceeded_ranges[i]->begin(),
+                     exceeded_ranges[i]->end());
   }
 
   return result;
 }
 
+Typing ModelSet::solveSeeded() {
+  // The base model is solved once instead of once per model, the seeds
+  // looking its types up in a dense table
+  Typing result = solve({base_});
+  Solution base(session_->getVariableCount());
+  base.add(result);
+  Typing typing = solve(base_->seed(models_, base));
+  result.insert(result.end(), typing.begin(), typing.end());
+  return result;
+}
+
 Model::shared_ptr ModelSet::getModel(int num) { return models_[num]; }
 
+const vector<SolverLimitError>& ModelSet::getExceeded() { return exceeded_; }
+
 }  // namespace solver
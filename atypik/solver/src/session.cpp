@@ -0,0 +1,71 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#include "session.h"
+
+using std::make_shared;
+
+namespace solver {
+
+namespace {
+// The session bound to the current thread by a Scope, if any
+thread_local Session::shared_ptr current_session = nullptr;
+}  // namespace
+
+Session::Scope::Scope(Session::shared_ptr session)
+    : previous_(current_session) {
+  current_session = session;
+}
+
+Session::Scope::~Scope() { current_session = previous_; }
+
+Session::shared_ptr Session::getCurrent() {
+  if (current_session == nullptr) return getDefault();
+  return current_session;
+}
+
+Session::shared_ptr Session::getDefault() {
+  static Session::shared_ptr session = make_shared<Session>();
+  return session;
+}
+
+int Session::nextVariableId() { return variables_++; }
+
+unsigned int Session::nextConstraintId() { return constraints_++; }
+
+int Session::getVariableCount() const { return variables_; }
+
+tools::Arena::shared_ptr Session::getArena() const { return arena_; }
+
+SolverPool &Session::getSolverPool() { return solver_pool_; }
+
+void Session::setBatchCost(size_t cost) { batch_cost_ = cost; }
+
+size_t Session::getBatchCost() const { return batch_cost_; }
+
+void Session::setCache(ModelCache::shared_ptr cache) { cache_ = cache; }
+
+ModelCache::shared_ptr Session::getCache() const { return cache_; }
+
+}  // namespace solver
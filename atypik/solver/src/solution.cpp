@@ -0,0 +1,54 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#include "solution.h"
+
+namespace solver {
+
+Solution::Solution(int size) : types_(size) {}
+
+AbstractBType::shared_ptr Solution::get(int id) const {
+  if (id < 0 or id >= size()) return nullptr;
+  return types_[id];
+}
+
+AbstractBType::shared_ptr Solution::get(Variable::shared_ptr variable) const {
+  return get(variable->getNumericId());
+}
+
+void Solution::set(int id, AbstractBType::shared_ptr type) {
+  // The variables created after the construction of the solution grow the
+  // table
+  if (id >= size()) types_.resize(id + 1);
+  types_[id] = type;
+}
+
+void Solution::add(const Typing &typing) {
+  for (auto &&[id, type] : typing)
+    if (get(id) == nullptr) set(id, type);
+}
+
+int Solution::size() const { return types_.size(); }
+
+}  // namespace solver
@@ -25,6 +25,7 @@
 #include "solverfactory.h"
 
 using namespace solver;
+using std::make_pair;
 using std::make_shared;
 using std::set;
 using std::shared_ptr;
@@ -39,12 +40,11 @@ const char* ConstructorError::what() const noexcept { return message_.c_str(); }
 
 Assertion::shared_ptr Factory::makeAssertion(
     AbstractConstraint::shared_ptr constraint) {
-  string str_constraint = constraint->toString();
-  if (assertions_.contains(str_constraint)) {
-    return assertions_[str_constraint];
-  }
-  Assertion::shared_ptr result = make_shared<Assertion>(constraint);
-  assertions_[str_constraint] = result;
+  // The constraints are hash-consed, so equal constraints share an assertion
+  if (assertions_.contains(constraint)) return assertions_[constraint];
+  Assertion::shared_ptr result =
+      make_shared<Assertion>(constraint, provenance_);
+  assertions_[constraint] = result;
   return result;
 }
 
@@ -70,7 +70,12 @@ BIdent::shared_ptr Factory::makeString() { return makeBIdent("STRING"); }
 
 BCartesianProduct::shared_ptr Factory::makeBCartesianProduct(
     AbstractBType::shared_ptr left, AbstractBType::shared_ptr right) {
-  return make_shared<BCartesianProduct>(left, right);
+  auto key = make_pair(left, right);
+  if (products_.contains(key)) return products_[key];
+  BCartesianProduct::shared_ptr result =
+      make_shared<BCartesianProduct>(left, right);
+  products_[key] = result;
+  return result;
 }
 
 BCartesianProduct::shared_ptr Factory::makeBCartesianProduct(
@@ -94,20 +99,38 @@ BPow::shared_ptr Factory::makeBPow(AbstractBType::shared_ptr type) {
 
 Equals::shared_ptr Factory::makeEquals(AbstractTerm::shared_ptr left,
                                        AbstractTerm::shared_ptr right) {
-  return make_shared<Equals>(left, right);
+  auto key = make_pair(left, right);
+  if (equalities_.contains(key)) return equalities_[key];
+  Equals::shared_ptr result = make_shared<Equals>(left, right);
+  equalities_[key] = result;
+  return result;
 }
 
 Or::shared_ptr Factory::makeOr(AbstractTerm::shared_ptr left,
                                AbstractTerm::shared_ptr right) {
-  return make_shared<Or>(left, right);
+  auto key = make_pair(left, right);
+  if (disjunctions_.contains(key)) return disjunctions_[key];
+  Or::shared_ptr result = make_shared<Or>(left, right);
+  disjunctions_[key] = result;
+  return result;
 }
 
 Not::shared_ptr Factory::makeNot(AbstractTerm::shared_ptr term) {
-  return make_shared<Not>(term);
+  if (negations_.contains(term)) return negations_[term];
+  Not::shared_ptr result = make_shared<Not>(term);
+  negations_[term] = result;
+  return result;
 }
 
 Model::shared_ptr Factory::makeModel() { return make_shared<Model>(); }
 
-Variable::shared_ptr Factory::makeVariable(string id) {
-  return make_shared<Variable>(id);
+Variable::shared_ptr Factory::makeVariable() { return make_shared<Variable>(); }
+
+void Factory::setProvenance(Provenance provenance) { provenance_ = provenance; }
+
+Provenance Factory::getProvenance() const { return provenance_; }
+
+void Factory::updateAssertions() {
+  for (auto &&[constraint, assertion] : assertions_)
+    assertion->updateVariableIds();
 }
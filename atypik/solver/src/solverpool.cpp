@@ -0,0 +1,115 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#include "solverpool.h"
+
+#include <algorithm>
+
+#include "cvc5_factory.h"
+#include "smt.h"
+
+using namespace smt;
+
+using std::lock_guard;
+using std::make_shared;
+using std::mutex;
+using std::sort;
+using std::string;
+using std::to_string;
+using std::unique;
+using std::vector;
+
+namespace solver {
+
+SolverInstance::shared_ptr SolverPool::acquire(
+    const vector<BIdent::shared_ptr> &datatypes) {
+  string key;
+  for (auto &&name : getNames(datatypes)) key += name + " ";
+  {
+    lock_guard<mutex> lock(mutex_);
+    vector<SolverInstance::shared_ptr> &idle = idle_[key];
+    if (not idle.empty()) {
+      SolverInstance::shared_ptr result = idle.back();
+      idle.pop_back();
+      return result;
+    }
+  }
+  return make(datatypes);
+}
+
+void SolverPool::release(SolverInstance::shared_ptr instance) {
+  if (instance->symbols.size() > max_symbols_) return;
+  instance->solver->reset_assertions();
+  lock_guard<mutex> lock(mutex_);
+  idle_[instance->key].push_back(instance);
+}
+
+SolverInstance::shared_ptr SolverPool::make(
+    const vector<BIdent::shared_ptr> &datatypes, bool explain) const {
+  SolverInstance::shared_ptr result = make_shared<SolverInstance>();
+  SmtSolver solver = Cvc5SolverFactory::create(false);
+  solver->set_opt("produce-models", "true");
+  if (explain) solver->set_opt("produce-unsat-assumptions", "true");
+  // Several checks are done on a solver, by incremental solving or by reuse
+  solver->set_opt("incremental", "true");
+  if (time_limit_ > 0) solver->set_opt("tlimit-per", to_string(time_limit_));
+  if (resource_limit_ > 0)
+    solver->set_opt("rlimit-per", to_string(resource_limit_));
+  solver->set_logic("QF_UFDT");
+
+  result->types = solver->make_datatype_decl("types");
+  DatatypeConstructorDecl pow = solver->make_datatype_constructor_decl("POW");
+  DatatypeConstructorDecl prod =
+      solver->make_datatype_constructor_decl("PRODUCT");
+  solver->add_selector_self(pow, "T");
+  solver->add_selector_self(prod, "A");
+  solver->add_selector_self(prod, "B");
+  solver->add_constructor(result->types, pow);
+  solver->add_constructor(result->types, prod);
+  for (auto &&name : getNames(datatypes)) {
+    DatatypeConstructorDecl type = solver->make_datatype_constructor_decl(name);
+    solver->add_constructor(result->types, type);
+    result->key += name + " ";
+  }
+  result->type_sort = solver->make_sort(result->types);
+  result->solver = solver;
+  return result;
+}
+
+void SolverPool::setLimits(unsigned int time, unsigned int resources) {
+  time_limit_ = time;
+  resource_limit_ = resources;
+}
+
+vector<string> SolverPool::getNames(
+    const vector<BIdent::shared_ptr> &datatypes) {
+  vector<string> result;
+  result.reserve(datatypes.size());
+  for (auto &&datatype : datatypes) result.push_back(datatype->toSMT());
+  sort(result.begin(), result.end());
+  result.erase(unique(result.begin(), result.end()), result.end());
+  return result;
+}
+
+}  // namespace solver
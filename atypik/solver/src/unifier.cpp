@@ -0,0 +1,342 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#include "unifier.h"
+
+using std::dynamic_pointer_cast;
+using std::pair;
+using std::set;
+using std::static_pointer_cast;
+using std::string;
+using std::unordered_map;
+using std::unordered_set;
+using std::vector;
+
+namespace solver {
+
+Unifier::Unifier(const vector<BIdent::shared_ptr> &datatypes) {
+  for (auto &&datatype : datatypes) datatypes_.insert(datatype->toSMT());
+}
+
+void Unifier::declare(const unordered_set<Variable::shared_ptr> &variables) {
+  for (auto &&variable : variables) {
+    int id = variable->getNumericId();
+    if (declared_.insert(id).second and not scopes_.empty())
+      new_declared_.push_back(id);
+  }
+}
+
+int Unifier::newNode(Kind kind, string name, int left, int right) {
+  int index = nodes_.size();
+  nodes_.push_back({kind, name, left, right});
+  parent_.push_back(index);
+  rank_.push_back(0);
+  // A constructor is the schema of its own class
+  schema_.push_back(kind == Kind::Variable ? -1 : index);
+  proof_parent_.push_back(-1);
+  proof_assertion_.push_back(-1);
+  proof_left_.push_back(-1);
+  proof_right_.push_back(-1);
+  return index;
+}
+
+void Unifier::assign(vector<int> &array, int index, int value) {
+  // Nodes created in the current scope are removed when it is closed, so
+  // their modifications do not need to be remembered
+  if (not scopes_.empty() and index < (int)scopes_.back().nodes)
+    writes_.push_back({&array, index, array[index]});
+  array[index] = value;
+}
+
+int Unifier::makeNode(AbstractTerm::shared_ptr term) {
+  if (terms_.contains(term.get())) return terms_[term.get()];
+
+  int result = -1;
+  if (Variable::shared_ptr var = dynamic_pointer_cast<Variable>(term)) {
+    int id = var->getNumericId();
+    // The SMT solver ignores the assertions on undeclared variables
+    if (not declared_.contains(id)) return -1;
+    if (not variable_nodes_.contains(id)) {
+      variable_nodes_[id] = newNode(Kind::Variable, var->toSMT());
+      if (not scopes_.empty()) new_variables_.push_back(id);
+    }
+    result = variable_nodes_[id];
+  } else if (BIdent::shared_ptr id = dynamic_pointer_cast<BIdent>(term)) {
+    string name = id->toSMT();
+    if (not datatypes_.contains(name)) return -1;
+    if (not ident_nodes_.contains(name)) {
+      ident_nodes_[name] = newNode(Kind::Ident, name);
+      if (not scopes_.empty()) new_idents_.push_back(name);
+    }
+    result = ident_nodes_[name];
+  } else if (BPow::shared_ptr pow = dynamic_pointer_cast<BPow>(term)) {
+    int type = makeNode(pow->getType());
+    if (type < 0) return -1;
+    result = newNode(Kind::Pow, "", type);
+  } else if (BCartesianProduct::shared_ptr product =
+                 dynamic_pointer_cast<BCartesianProduct>(term)) {
+    int left = makeNode(product->getLeft());
+    int right = makeNode(product->getRight());
+    if (left < 0 or right < 0) return -1;
+    result = newNode(Kind::Product, "", left, right);
+  } else
+    return -1;
+
+  terms_[term.get()] = result;
+  if (not scopes_.empty()) new_terms_.push_back(term.get());
+  return result;
+}
+
+int Unifier::find(int node) {
+  int root = node;
+  while (parent_[root] != root) root = parent_[root];
+  // Path compression
+  while (parent_[node] != root) {
+    int next = parent_[node];
+    assign(parent_, node, root);
+    node = next;
+  }
+  return root;
+}
+
+void Unifier::link(const Equation &equation) {
+  // The path from the left node to its root is reversed, each edge keeping
+  // its label
+  int node = equation.left;
+  int child = -1, assertion = -1, left = -1, right = -1;
+  while (node >= 0) {
+    int parent = proof_parent_[node];
+    int next_assertion = proof_assertion_[node];
+    int next_left = proof_left_[node];
+    int next_right = proof_right_[node];
+    assign(proof_parent_, node, child);
+    assign(proof_assertion_, node, assertion);
+    assign(proof_left_, node, left);
+    assign(proof_right_, node, right);
+    child = node;
+    node = parent;
+    assertion = next_assertion;
+    left = next_left;
+    right = next_right;
+  }
+  assign(proof_parent_, equation.left, equation.right);
+  assign(proof_assertion_, equation.left, equation.assertion);
+  assign(proof_left_, equation.left, equation.left_constructor);
+  assign(proof_right_, equation.left, equation.right_constructor);
+}
+
+void Unifier::explain(int left, int right, set<int> &core) {
+  set<pair<int, int>> explained;
+  vector<pair<int, int>> stack = {{left, right}};
+  while (not stack.empty()) {
+    auto [a, b] = stack.back();
+    stack.pop_back();
+    if (a == b or not explained.insert({a, b}).second) continue;
+
+    // The edges between the nodes and their closest common ancestor
+    unordered_set<int> ancestors;
+    for (int node = a; node >= 0; node = proof_parent_[node])
+      ancestors.insert(node);
+    int common = b;
+    while (not ancestors.contains(common)) common = proof_parent_[common];
+    for (int start : {a, b})
+      for (int node = start; node != common; node = proof_parent_[node]) {
+        if (proof_assertion_[node] >= 0)
+          core.insert(proof_assertion_[node]);
+        else
+          stack.push_back({proof_left_[node], proof_right_[node]});
+      }
+  }
+}
+
+bool Unifier::occurs(int root, int constructor, vector<pair<int, int>> &path,
+                     unordered_set<int> &visited) {
+  const Node &node = nodes_[constructor];
+  for (int member : {node.left, node.right}) {
+    if (member < 0) continue;
+    int rep = find(member);
+    if (rep == root) {
+      path.push_back({member, schema_[root]});
+      return true;
+    }
+    if (schema_[rep] < 0 or not visited.insert(rep).second) continue;
+    path.push_back({member, schema_[rep]});
+    if (occurs(root, schema_[rep], path, visited)) return true;
+    path.pop_back();
+  }
+  return false;
+}
+
+SolverError Unifier::unsatisfiable(string message, const set<int> &core) {
+  vector<Assertion::shared_ptr> unsolved;
+  for (int index : core) unsolved.push_back(asserted_[index]);
+  return SolverError("Model is unsatisfiable. " + message, unsolved);
+}
+
+void Unifier::add(Assertion::shared_ptr assertion) {
+  Equals::shared_ptr constraint =
+      static_pointer_cast<Equals>(assertion->getConstraint());
+  int left = makeNode(constraint->getLeft());
+  int right = makeNode(constraint->getRight());
+  if (left < 0 or right < 0) return;
+  asserted_.push_back(assertion);
+
+  vector<Equation> stack = {{left, right, (int)asserted_.size() - 1, -1, -1}};
+  while (not stack.empty()) {
+    Equation equation = stack.back();
+    stack.pop_back();
+    int a = find(equation.left);
+    int b = find(equation.right);
+    if (a == b) continue;
+
+    int schema_a = schema_[a];
+    int schema_b = schema_[b];
+    if (schema_a >= 0 and schema_b >= 0) {
+      const Node &node_a = nodes_[schema_a];
+      const Node &node_b = nodes_[schema_b];
+      if (node_a.kind != node_b.kind or node_a.name != node_b.name) {
+        // Once the equation is in the proof forest, the path between the
+        // clashing constructors goes through it
+        set<int> core;
+        link(equation);
+        explain(schema_a, schema_b, core);
+        throw unsatisfiable(
+            "The following constraints are not compatible:\n", core);
+      }
+      if (node_a.left >= 0)
+        stack.push_back({node_a.left, node_b.left, -1, schema_a, schema_b});
+      if (node_a.right >= 0)
+        stack.push_back({node_a.right, node_b.right, -1, schema_a, schema_b});
+    }
+
+    // Union by rank, the merged class keeps a constructor if any
+    link(equation);
+    if (rank_[a] < rank_[b]) std::swap(a, b);
+    assign(parent_, b, a);
+    if (rank_[a] == rank_[b]) assign(rank_, a, rank_[a] + 1);
+    if (schema_[a] < 0)
+      assign(schema_, a, schema_a >= 0 ? schema_a : schema_b);
+
+    // Occurs check: the members of the constructor must not lead back to the
+    // merged class. Since it is done at each union, the constructors never
+    // form a cycle.
+    vector<pair<int, int>> path;
+    unordered_set<int> visited;
+    if (schema_[a] >= 0 and occurs(a, schema_[a], path, visited)) {
+      set<int> core;
+      for (auto [member, constructor] : path)
+        explain(member, constructor, core);
+      throw unsatisfiable(
+          "The following constraints would give an infinite type:\n", core);
+    }
+  }
+}
+
+void Unifier::push() {
+  scopes_.push_back({nodes_.size(), writes_.size(), new_declared_.size(),
+                     new_terms_.size(), new_variables_.size(),
+                     new_idents_.size(), asserted_.size()});
+}
+
+void Unifier::pop() {
+  Scope scope = scopes_.back();
+  scopes_.pop_back();
+
+  while (writes_.size() > scope.writes) {
+    Write write = writes_.back();
+    writes_.pop_back();
+    (*write.array)[write.index] = write.old_value;
+  }
+  nodes_.resize(scope.nodes);
+  parent_.resize(scope.nodes);
+  rank_.resize(scope.nodes);
+  schema_.resize(scope.nodes);
+  proof_parent_.resize(scope.nodes);
+  proof_assertion_.resize(scope.nodes);
+  proof_left_.resize(scope.nodes);
+  proof_right_.resize(scope.nodes);
+  asserted_.resize(scope.asserted);
+
+  for (size_t i = scope.declared; i < new_declared_.size(); i++)
+    declared_.erase(new_declared_[i]);
+  new_declared_.resize(scope.declared);
+  for (size_t i = scope.terms; i < new_terms_.size(); i++)
+    terms_.erase(new_terms_[i]);
+  new_terms_.resize(scope.terms);
+  for (size_t i = scope.variables; i < new_variables_.size(); i++)
+    variable_nodes_.erase(new_variables_[i]);
+  new_variables_.resize(scope.variables);
+  for (size_t i = scope.idents; i < new_idents_.size(); i++)
+    ident_nodes_.erase(new_idents_[i]);
+  new_idents_.resize(scope.idents);
+}
+
+AbstractBType::shared_ptr Unifier::typeOf(
+    int node, unordered_map<int, AbstractBType::shared_ptr> &cache) {
+  int rep = find(node);
+  if (cache.contains(rep)) return cache[rep];
+
+  AbstractBType::shared_ptr result;
+  int schema = schema_[rep];
+  if (schema < 0)
+    // Unconstrained types are instanciated by the generic type
+    result = factory_.makeBIdent("A");
+  else {
+    const Node &constructor = nodes_[schema];
+    switch (constructor.kind) {
+      case Kind::Ident:
+        result = factory_.makeBIdent(constructor.name);
+        break;
+      case Kind::Pow:
+        result = factory_.makeBPow(typeOf(constructor.left, cache));
+        break;
+      case Kind::Product:
+        result = factory_.makeBCartesianProduct(
+            typeOf(constructor.left, cache), typeOf(constructor.right, cache));
+        break;
+      case Kind::Variable:
+        break;
+    }
+  }
+
+  return cache[rep] = result;
+}
+
+Typing Unifier::solve(const unordered_set<Variable::shared_ptr> &variables) {
+  Typing result;
+  result.reserve(variables.size());
+  unordered_map<int, AbstractBType::shared_ptr> cache;
+
+  for (auto &&variable : variables) {
+    int id = variable->getNumericId();
+    if (not variable_nodes_.contains(id)) {
+      result.emplace_back(id, factory_.makeBIdent("A"));
+      continue;
+    }
+    result.emplace_back(id, typeOf(variable_nodes_[id], cache));
+  }
+  return result;
+}
+
+}  // namespace solver
@@ -24,11 +24,32 @@
  */
 #include "vargen.h"
 
+using std::vector;
+
 using namespace solver;
-using std::to_string;
 
-int VarGenerator::cpt_ = 0;
+namespace {
+// The variables generated by the current thread are appended to this vector
+// while a record is alive
+thread_local vector<Variable::shared_ptr> *recorded = nullptr;
+}  // namespace
 
 Variable::shared_ptr VarGenerator::getNewVariable() {
-  return Factory::makeVariable("type__" + to_string(cpt_++));
+  Variable::shared_ptr result = Factory::makeVariable();
+  if (recorded != nullptr) recorded->push_back(result);
+  return result;
+}
+
+int VarGenerator::renumber(const vector<Variable::shared_ptr> &variables,
+                           int first) {
+  for (const Variable::shared_ptr &variable : variables)
+    variable->numeric_id_ = first++;
+  return first;
 }
+
+VarGenerator::Record::Record(vector<Variable::shared_ptr> &variables)
+    : previous_(recorded) {
+  recorded = &variables;
+}
+
+VarGenerator::Record::~Record() { recorded = previous_; }
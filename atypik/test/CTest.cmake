@@ -42,3 +42,36 @@ foreach (index RANGE ${range})
     add_test(NAME "${name}-${machine}"
         COMMAND types-comparator "${folder}/src/${machine}.bxml" "--bxml" "${folder}/expected/${machine}.csv" "${folder}/src/")
 endforeach()
+
+# The pog files are checked in each way of parsing and solving the proof
+# obligations
+set(PogToTest
+    "Pog"
+    )
+
+set(PogModes
+    "multi-thread"
+    "single-thread"
+    "incremental"
+    "seed-defines"
+    )
+
+set(PogModeOptions
+    ""
+    "--disable-multi-thread"
+    "--incremental"
+    "--seed-defines"
+    )
+
+list(LENGTH PogModes nbModes)
+math(EXPR modeRange "${nbModes} - 1")
+
+foreach (machine ${PogToTest})
+    set(folder "${CMAKE_SOURCE_DIR}/test/data/test_pog")
+    foreach (index RANGE ${modeRange})
+        list(GET PogModes ${index} mode)
+        list(GET PogModeOptions ${index} option)
+        add_test(NAME "test_pog-${machine}-${mode}"
+            COMMAND types-comparator "--pog" "--abstraction" ${option} "${folder}/src/${machine}.pog" "${folder}/expected/${machine}.csv")
+    endforeach()
+endforeach()
@@ -28,6 +28,7 @@
 #include "bxmlparser.h"
 #include "expression.h"
 #include "set.h"
+#include "solution.h"
 #include "solverfactory.h"
 
 namespace test {
@@ -50,7 +51,7 @@ public:
      * The delimter between the columns
      */
     static void writeTemplate(std::unordered_set<belem::Expression::shared_ptr> expressions,
-                              std::unordered_map<solver::Variable::shared_ptr, std::string> var_to_type = {},
+                              const solver::Solution &var_to_type = {},
                               std::string output="",
                               std::string delimiter=";");
 };
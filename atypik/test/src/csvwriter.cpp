@@ -44,7 +44,8 @@ using std::vector;
 namespace test {
 void CSVWriter::writeTemplate(
     unordered_set<Expression::shared_ptr> expressions,
-    unordered_map<Variable::shared_ptr, string> var_to_type, string output,
+    const Solution& var_to_type,
+    string output,
     string delimiter) {
   // Setting the buffer to write in the selected output
   streambuf* buffer;
@@ -72,8 +73,8 @@ void CSVWriter::writeTemplate(
     if (first_pos == nullptr) continue;
 
     Variable::shared_ptr variable = expression->getAssociatedVariable();
-    string expected_type =
-        var_to_type.contains(variable) ? var_to_type[variable] : "";
+    AbstractBType::shared_ptr type = var_to_type.get(variable);
+    string expected_type = type != nullptr ? type->toSMT() : "";
 
     out << "\"" << expression->format() << "\"" << delimiter
         << variable->getNumericId() << delimiter << first_pos->getLine()
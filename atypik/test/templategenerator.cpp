@@ -68,7 +68,7 @@ void write(genericparser::Parser::unique_ptr parser,
   vector<Model::shared_ptr> models = context->getModels();
   const unordered_set<Expression::shared_ptr> expressions =
       context->getExpressions();
-  unordered_map<Variable::shared_ptr, string> var_to_type;
+  Solution var_to_type;
   try {
     ModelSet modelset = ModelSet(models);
     var_to_type = modelset.solve();
@@ -53,12 +53,25 @@ void displayHelp(string prog) {
   cout << "Options:" << endl;
   cout << "--bxml \t parse a bxml file" << endl;
   cout << "--pog \t parse a pog file" << endl;
+  cout << "--disable-multi-thread \t parse and solve the proof obligations of "
+          "pog files in a single thread"
+       << endl;
+  cout << "--incremental \t solve the proof obligations of pog files "
+          "incrementally on top of the Define constraints"
+       << endl;
+  cout << "--seed-defines \t solve the Define constraints of pog files once "
+          "and seed the proof obligations with their types"
+       << endl;
+  cout << "--abstraction \t for pog files generated from abstract machines"
+       << endl;
+  cout << "--implementation \t for pog files generated from implementations"
+       << endl;
   cout << "--help \t display the help menu" << endl;
 }
 
 int check_types(genericparser::Parser::unique_ptr parser,
                 genericwriter::Writer::unique_ptr writer, string input,
-                string expected) {
+                string expected, ModelSet::Strategy strategy) {
   // Defining the indexes of the columns
   const int expression = 0;
   const int id = 1;
@@ -72,32 +85,36 @@ int check_types(genericparser::Parser::unique_ptr parser,
   vector<Model::shared_ptr> models = context->getModels();
   const unordered_set<Expression::shared_ptr> expressions =
       context->getExpressions();
-  unordered_map<Variable::shared_ptr, string> var_to_type;
+  Solution var_to_type;
+  unordered_map<int, Expression::shared_ptr> id_to_expression;
+
+  for (auto&& exp : expressions)
+    id_to_expression[exp->getAssociatedVariable()->getNumericId()] = exp;
+
   try {
-    ModelSet modelset = ModelSet(models);
+    Model::shared_ptr base = context->getBaseModel();
+    ModelSet modelset = base != nullptr ? ModelSet(base, models, strategy)
+                                        : ModelSet(models);
     var_to_type = modelset.solve();
 
   } catch (SolverError e) {
-    unordered_map<string, string> terms;
-    for (auto expr : expressions)
-      terms[expr->getAssociatedVariable()->toSMT()] =
-          "t(" + expr->format() + ")";
-    e.replaceTerms(terms);
+    e.describeVariables([&id_to_expression](int id) {
+      auto exp = id_to_expression.find(id);
+      if (exp == id_to_expression.end()) return string();
+      return "t(" + exp->second->format() + ")";
+    });
     throw e;
   }
 
   ifstream file(expected);
   int nb_rows = 0;
-  unordered_map<int, Expression::shared_ptr> id_to_expression;
   int result = 0;
 
-  for (auto&& exp : expressions)
-    id_to_expression[exp->getAssociatedVariable()->getNumericId()] = exp;
-
   for (auto&& row : CSVRange(file, "\t", true)) {
     nb_rows++;
     string actual_type =
-        var_to_type[id_to_expression[stoi(row[id])]->getAssociatedVariable()];
+        var_to_type.get(id_to_expression[stoi(row[id])]->getAssociatedVariable())
+            ->toSMT();
     string expected_type = row[type];
     if (actual_type != expected_type) {
       cerr << "Line " << nb_rows << " : Actual type "
@@ -112,10 +129,16 @@ int check_types(genericparser::Parser::unique_ptr parser,
 
 int main(int argc, char** argv) {
   const char* const short_opts = "";
-  const struct option long_opts[] = {{"bxml", no_argument, nullptr, 'b'},
-                                     {"pog", no_argument, nullptr, 'p'},
-                                     {"help", no_argument, nullptr, 'h'},
-                                     {nullptr, no_argument, nullptr, 0}};
+  const struct option long_opts[] = {
+      {"bxml", no_argument, nullptr, 'b'},
+      {"pog", no_argument, nullptr, 'p'},
+      {"disable-multi-thread", no_argument, nullptr, 'd'},
+      {"incremental", no_argument, nullptr, 'n'},
+      {"seed-defines", no_argument, nullptr, 's'},
+      {"abstraction", no_argument, nullptr, 'a'},
+      {"implementation", no_argument, nullptr, 'i'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
 
   bxml::Parser::unique_ptr bxml_parser;
   pog::Parser::unique_ptr pog_parser;
@@ -123,6 +146,11 @@ int main(int argc, char** argv) {
   int opt;
   vector<string> bxml_folders;
   bool pog = false, bxml = false;
+  bool disable_multi_thread = false;
+  bool incremental = false;
+  bool seed_defines = false;
+  genericparser::MachineType machine_type =
+      genericparser::MachineType::Undefined;
   while ((opt = getopt_long(argc, argv, short_opts, long_opts, nullptr)) !=
          -1) {
     switch (opt) {
@@ -142,6 +170,21 @@ int main(int argc, char** argv) {
         }
         pog = true;
         break;
+      case 'd':
+        disable_multi_thread = true;
+        break;
+      case 'n':
+        incremental = true;
+        break;
+      case 's':
+        seed_defines = true;
+        break;
+      case 'a':
+        machine_type = genericparser::MachineType::Abstraction;
+        break;
+      case 'i':
+        machine_type = genericparser::MachineType::Implementation;
+        break;
       case 'h':
         displayHelp(argv[0]);
         return 0;
@@ -150,7 +193,7 @@ int main(int argc, char** argv) {
     }
   }
 
-  if (argc - optind <= 2) {
+  if (argc - optind < 2) {
     cerr << argv[0] << " takes at least two arguments." << endl;
     cerr << "Run " << argv[0] << " --help for more information" << endl;
     exit(1);
@@ -166,9 +209,22 @@ int main(int argc, char** argv) {
     for (unsigned int i = optind + 2; i < argc; i++)
       bxml_folders.emplace_back(argv[i]);
     bxml_parser->addFolders(bxml_folders);
-    return check_types(move(bxml_parser), move(writer), input, expected);
+    return check_types(move(bxml_parser), move(writer), input, expected,
+                       ModelSet::Strategy::Incremental);
+  }
+  if (pog) {
+    if (machine_type == genericparser::MachineType::Undefined) {
+      cerr << "Machine type has to be given." << endl;
+      exit(1);
+    }
+    pog_parser->setMachineType(machine_type);
+    if (disable_multi_thread) pog_parser->disableMultiThread();
+    if (incremental) pog_parser->enableIncrementalSolving();
+    if (seed_defines) pog_parser->enableDefinesSeeding();
+    return check_types(move(pog_parser), move(writer), input, expected,
+                       seed_defines ? ModelSet::Strategy::Seeded
+                                    : ModelSet::Strategy::Incremental);
   }
-  if (pog) return check_types(move(pog_parser), move(writer), input, expected);
 
   return 1;
 }
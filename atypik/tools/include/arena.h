@@ -0,0 +1,130 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace tools {
+
+/*!
+ * \brief The Arena class allocates memory by bumping a pointer in large
+ * chunks, which are only released with the arena. Each thread bumps its own
+ * chunk, so that concurrent allocations only synchronize to get a new chunk.
+ */
+class Arena {
+public:
+    /*!
+     * \brief A shared pointer on an Arena
+     */
+    typedef std::shared_ptr<Arena> shared_ptr;
+    /*!
+     * \brief Instanciate an empty arena
+     * \param chunk_size
+     * The size of the chunks given to the threads
+     */
+    Arena(size_t chunk_size = 64 * 1024);
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    /*!
+     * \brief Allocate memory in the arena
+     * \param size
+     * The size of the memory
+     * \param alignment
+     * The alignment of the memory, a power of two up to the alignment of
+     * std::max_align_t
+     * \return a pointer on the memory, valid until the arena is destroyed
+     */
+    void *allocate(size_t size, size_t alignment);
+
+private:
+    /*!
+     * \brief The identifier of the arena, telling the chunks of the threads
+     * apart from those of the arenas previously destroyed
+     */
+    const uint64_t id_;
+    /*!
+     * \brief The size of the chunks
+     */
+    const size_t chunk_size_;
+    /*!
+     * \brief The mutex protecting the chunks
+     */
+    std::mutex mutex_;
+    /*!
+     * \brief The chunks of memory of the arena
+     */
+    std::vector<std::unique_ptr<std::byte[]>> chunks_;
+    /*!
+     * \brief Allocate a new chunk
+     * \param size
+     * The size of the chunk
+     * \return a pointer on the chunk
+     */
+    std::byte *allocateChunk(size_t size);
+};
+
+/*!
+ * \brief The ArenaAllocator class is a standard allocator taking its memory
+ * from an arena, which it keeps alive. Deallocations do nothing: the memory is
+ * released with the arena.
+ */
+template <class T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+    /*!
+     * \brief Instanciate an allocator
+     * \param arena
+     * The arena giving the memory
+     */
+    ArenaAllocator(Arena::shared_ptr arena) : arena_(std::move(arena)) {}
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena_(other.arena_) {}
+    T *allocate(size_t n) {
+        return static_cast<T *>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T *, size_t) noexcept {}
+    template <class U>
+    bool operator==(const ArenaAllocator<U> &other) const {
+        return arena_ == other.arena_;
+    }
+
+private:
+    template <class U>
+    friend class ArenaAllocator;
+    /*!
+     * \brief The arena giving the memory
+     */
+    Arena::shared_ptr arena_;
+};
+
+}
+
+#endif // ARENA_H
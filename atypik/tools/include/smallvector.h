@@ -0,0 +1,98 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#ifndef SMALLVECTOR_H
+#define SMALLVECTOR_H
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+namespace tools {
+
+/*!
+ * \brief The SmallVector class is a sequence keeping up to N elements inline,
+ * without any allocation, and moving them to the heap beyond
+ */
+template <class T, size_t N>
+class SmallVector {
+public:
+    SmallVector() = default;
+    SmallVector(std::initializer_list<T> elements) {
+        for (const T &element : elements)
+            push_back(element);
+    }
+    /*!
+     * \brief Add an element at the end of the sequence
+     * \param element
+     * The element
+     */
+    void push_back(T element) {
+        if (heap_.empty()) {
+            if (size_ < N) {
+                inline_[size_++] = std::move(element);
+                return;
+            }
+            heap_.reserve(2 * N);
+            for (T &inlined : inline_)
+                heap_.push_back(std::exchange(inlined, T()));
+        }
+        heap_.push_back(std::move(element));
+        size_++;
+    }
+    /*!
+     * \brief Remove all the elements
+     */
+    void clear() {
+        inline_.fill(T());
+        heap_.clear();
+        size_ = 0;
+    }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    T *begin() { return heap_.empty() ? inline_.data() : heap_.data(); }
+    T *end() { return begin() + size_; }
+    const T *begin() const { return heap_.empty() ? inline_.data() : heap_.data(); }
+    const T *end() const { return begin() + size_; }
+
+private:
+    /*!
+     * \brief The elements while there are at most N of them
+     */
+    std::array<T, N> inline_{};
+    /*!
+     * \brief The elements when there are more than N of them
+     */
+    std::vector<T> heap_;
+    /*!
+     * \brief The number of elements
+     */
+    size_t size_ = 0;
+};
+
+}
+
+#endif // SMALLVECTOR_H
@@ -0,0 +1,167 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace tools {
+
+/*!
+ * \brief The ThreadPool class runs tasks on a fixed number of threads. Each
+ * thread has its own queue of tasks, running them in the order they were
+ * submitted, and steals the last tasks of the other queues when its own is
+ * empty.
+ */
+class ThreadPool {
+public:
+    /*!
+     * \brief Instanciate a thread pool
+     * \param size
+     * The number of threads, the number of hardware threads if 0
+     */
+    ThreadPool(unsigned int size = 0);
+    /*!
+     * \brief Wait for the running tasks and stop the threads. The tasks
+     * which are not started yet are discarded.
+     */
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    /*!
+     * \brief Add a task to the pool. The tasks submitted from outside the
+     * pool are distributed among the threads in turn, the tasks submitted by
+     * a thread of the pool are added to its own queue.
+     * \param task
+     * The task
+     * \return a future on the result of the task
+     */
+    template <class Task>
+    std::future<std::invoke_result_t<Task>> submit(Task task);
+    /*!
+     * \brief An accessor on the number of threads of the pool
+     * \return the number of threads of the pool
+     */
+    unsigned int size();
+    /*!
+     * \brief Set the number of threads of the shared pool. It must be called
+     * before the first use of the shared pool.
+     * \param size
+     * The number of threads, the number of hardware threads if 0
+     */
+    static void setSharedSize(unsigned int size);
+    /*!
+     * \brief An accessor on the pool shared by the phases of atypik
+     * \return the shared pool
+     */
+    static ThreadPool &getShared();
+
+private:
+    /*!
+     * \brief The queue of tasks of a thread
+     */
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+    /*!
+     * \brief The threads of the pool
+     */
+    std::vector<std::thread> threads_;
+    /*!
+     * \brief The queue of each thread
+     */
+    std::vector<std::unique_ptr<Queue>> queues_;
+    /*!
+     * \brief The queue receiving the next task submitted from outside the pool
+     */
+    std::atomic<size_t> next_queue_;
+    /*!
+     * \brief The mutex protecting pending_ and stopped_
+     */
+    std::mutex mutex_;
+    /*!
+     * \brief The condition notified when a task is added or the pool stops
+     */
+    std::condition_variable condition_;
+    /*!
+     * \brief The number of tasks waiting in the queues
+     */
+    size_t pending_;
+    /*!
+     * \brief A boolean telling if the pool is stopping
+     */
+    bool stopped_;
+    /*!
+     * \brief The number of threads of the shared pool
+     */
+    static unsigned int shared_size_;
+    /*!
+     * \brief Add a task to a queue of the pool
+     * \param task
+     * The task
+     */
+    void enqueue(std::function<void()> task);
+    /*!
+     * \brief Take the next task of a thread, stealing it from another thread
+     * if its queue is empty
+     * \param index
+     * The index of the thread
+     * \param task
+     * The task taken
+     * \return true if a task was taken, false if all the queues are empty
+     */
+    bool take(size_t index, std::function<void()> &task);
+    /*!
+     * \brief Run the tasks of the pool until it stops
+     * \param index
+     * The index of the thread
+     */
+    void work(size_t index);
+};
+
+template <class Task>
+std::future<std::invoke_result_t<Task>> ThreadPool::submit(Task task) {
+    using Result = std::invoke_result_t<Task>;
+    // std::function needs a copyable callable
+    auto packaged =
+        std::make_shared<std::packaged_task<Result()>>(std::move(task));
+    std::future<Result> result = packaged->get_future();
+    enqueue([packaged]() { (*packaged)(); });
+    return result;
+}
+
+}
+
+#endif // THREADPOOL_H
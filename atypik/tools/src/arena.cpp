@@ -0,0 +1,100 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#include "arena.h"
+
+#include <atomic>
+
+using std::byte;
+using std::lock_guard;
+using std::make_unique_for_overwrite;
+using std::move;
+using std::mutex;
+
+namespace tools {
+
+namespace {
+// The identifiers of the arenas are never reused
+std::atomic<uint64_t> next_arena_id = 1;
+
+// A chunk bumped by the current thread and the arena it belongs to
+struct Cursor {
+  uint64_t arena = 0;
+  byte *next = nullptr;
+  byte *end = nullptr;
+};
+
+// The threads of the pool alternate between the arenas of several sessions,
+// so each thread keeps a chunk for each of the last arenas it used. The
+// oldest cursor is replaced when a thread uses more arenas, the rest of its
+// chunk being lost.
+const size_t cursors_count = 8;
+struct Cursors {
+  Cursor slots[cursors_count];
+  size_t replaced = 0;
+};
+thread_local Cursors cursors;
+
+// The cursor of the current thread in an arena, a new one without chunk if
+// the thread did not use the arena recently
+Cursor &getCursor(uint64_t arena) {
+  for (Cursor &cursor : cursors.slots)
+    if (cursor.arena == arena) return cursor;
+  Cursor &cursor = cursors.slots[cursors.replaced++ % cursors_count];
+  cursor = {arena, nullptr, nullptr};
+  return cursor;
+}
+}  // namespace
+
+Arena::Arena(size_t chunk_size)
+    : id_(next_arena_id++), chunk_size_(chunk_size) {}
+
+void *Arena::allocate(size_t size, size_t alignment) {
+  // The large blocks get their own chunk, so as not to waste the chunk of the
+  // thread
+  if (size > chunk_size_ / 4) return allocateChunk(size);
+  Cursor &cursor = getCursor(id_);
+  if (cursor.next != nullptr) {
+    uintptr_t next = reinterpret_cast<uintptr_t>(cursor.next);
+    uintptr_t aligned = (next + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    if (aligned + size <= reinterpret_cast<uintptr_t>(cursor.end)) {
+      cursor.next = reinterpret_cast<byte *>(aligned + size);
+      return reinterpret_cast<void *>(aligned);
+    }
+  }
+  // The chunks are aligned for any type
+  byte *chunk = allocateChunk(chunk_size_);
+  cursor = {id_, chunk + size, chunk + chunk_size_};
+  return chunk;
+}
+
+byte *Arena::allocateChunk(size_t size) {
+  auto chunk = make_unique_for_overwrite<byte[]>(size);
+  byte *result = chunk.get();
+  lock_guard<mutex> lock(mutex_);
+  chunks_.push_back(move(chunk));
+  return result;
+}
+
+}  // namespace tools
@@ -0,0 +1,129 @@
+/*
+ * A TYPe Inference Kit for B.
+ *
+ * This file is part of the atypik project.
+ * Copyright (c) 2023 CLEARSY
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License version 3
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>. 
+ *
+ * You can be released from the requirements of the license by purchasing
+ * a commercial license. Buying such a license is mandatory as soon as you
+ * develop commercial activities involving the atypik software without
+ * disclosing the source code of your own applications.
+ *
+ */
+#include "threadpool.h"
+
+using std::function;
+using std::lock_guard;
+using std::make_unique;
+using std::move;
+using std::mutex;
+using std::thread;
+using std::unique_lock;
+
+namespace tools {
+
+namespace {
+// The pool and the index of the current thread if it belongs to a pool
+thread_local ThreadPool *current_pool = nullptr;
+thread_local size_t current_index = 0;
+}  // namespace
+
+unsigned int ThreadPool::shared_size_ = 0;
+
+ThreadPool::ThreadPool(unsigned int size)
+    : next_queue_(0), pending_(0), stopped_(false) {
+  if (size == 0) size = thread::hardware_concurrency();
+  // hardware_concurrency may not be computable
+  if (size == 0) size = 1;
+  queues_.reserve(size);
+  for (unsigned int i = 0; i < size; i++)
+    queues_.push_back(make_unique<Queue>());
+  threads_.reserve(size);
+  for (unsigned int i = 0; i < size; i++)
+    threads_.emplace_back(&ThreadPool::work, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    lock_guard<mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  condition_.notify_all();
+  for (auto &&worker : threads_) worker.join();
+}
+
+unsigned int ThreadPool::size() { return threads_.size(); }
+
+void ThreadPool::setSharedSize(unsigned int size) { shared_size_ = size; }
+
+ThreadPool &ThreadPool::getShared() {
+  static ThreadPool shared(shared_size_);
+  return shared;
+}
+
+void ThreadPool::enqueue(function<void()> task) {
+  size_t index = current_pool == this
+                     ? current_index
+                     : next_queue_.fetch_add(1) % queues_.size();
+  {
+    lock_guard<mutex> lock(queues_[index]->mutex);
+    queues_[index]->tasks.push_back(move(task));
+  }
+  {
+    lock_guard<mutex> lock(mutex_);
+    pending_++;
+  }
+  condition_.notify_one();
+}
+
+bool ThreadPool::take(size_t index, function<void()> &task) {
+  for (size_t i = 0; i < queues_.size(); i++) {
+    Queue &queue = *queues_[(index + i) % queues_.size()];
+    lock_guard<mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) continue;
+    // The own queue is run in order, the other ones are stolen from the back
+    if (i == 0) {
+      task = move(queue.tasks.front());
+      queue.tasks.pop_front();
+    } else {
+      task = move(queue.tasks.back());
+      queue.tasks.pop_back();
+    }
+    return true;
+  }
+  return false;
+}
+
+void ThreadPool::work(size_t index) {
+  current_pool = this;
+  current_index = index;
+  while (true) {
+    {
+      unique_lock<mutex> lock(mutex_);
+      condition_.wait(lock, [this] { return stopped_ or pending_ > 0; });
+      if (stopped_) return;
+    }
+    function<void()> task;
+    // Another thread may have taken the task in the meantime
+    if (not take(index, task)) continue;
+    {
+      lock_guard<mutex> lock(mutex_);
+      pending_--;
+    }
+    task();
+  }
+}
+
+}  // namespace tools